@@ -0,0 +1,171 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "CommandRecorder.h"
+#include "VulkanCore.h"
+
+#include <algorithm>
+#include <chrono>
+
+CommandRecorder::~CommandRecorder() {
+    destroy();
+}
+
+void CommandRecorder::init(VulkanCore &core, uint32_t framesInFlight, uint32_t threadCount) {
+    assert(framesInFlight > 0u);
+    destroy();
+    m_core = &core;
+    m_threadCount = threadCount;
+    m_frame = 0u;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = static_cast<uint32_t>(m_core->getQueueFamily());
+    m_pools.resize(size_t(framesInFlight) * threadCount);
+    for (auto &pool: m_pools) {
+        VK_CHECK(vkCreateCommandPool(m_core->getDevice(), &poolInfo, nullptr, &pool.pool));
+    }
+
+    m_stats.assign(std::max(threadCount, 1u), ThreadStats{});
+    m_stop = false;
+    for (uint32_t thread = 0u; thread < threadCount; ++thread) {
+        m_workers.emplace_back(&CommandRecorder::run, this, thread);
+    }
+}
+
+void CommandRecorder::destroy() {
+    if (!m_core) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobCv.notify_all();
+    for (auto &worker: m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+    // destroying a pool frees its buffers
+    for (auto &pool: m_pools) {
+        vkDestroyCommandPool(m_core->getDevice(), pool.pool, nullptr);
+    }
+    m_pools.clear();
+    m_jobs.clear();
+    m_recorded.clear();
+    m_nextJob = 0u;
+    m_doneJobs = 0u;
+    m_threadCount = 0u;
+    m_core = nullptr;
+}
+
+void CommandRecorder::beginFrame(uint32_t frame, VkRenderPass renderPass,
+                                 VkFramebuffer framebuffer) {
+    assert(m_core);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    assert(m_doneJobs == m_jobs.size()); // execute waited for the previous frame
+    m_frame = frame;
+    for (uint32_t thread = 0u; thread < m_threadCount; ++thread) {
+        FramePool &pool = getPool(thread);
+        VK_CHECK(vkResetCommandPool(m_core->getDevice(), pool.pool, 0));
+        pool.used = 0u;
+    }
+    m_inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    m_inheritance.renderPass = renderPass;
+    m_inheritance.subpass = 0;
+    m_inheritance.framebuffer = framebuffer;
+    m_jobs.clear();
+    m_recorded.clear();
+    m_nextJob = 0u;
+    m_doneJobs = 0u;
+}
+
+void CommandRecorder::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+        m_recorded.push_back(VK_NULL_HANDLE);
+    }
+    m_jobCv.notify_one();
+}
+
+void CommandRecorder::execute(VkCommandBuffer primary) {
+    if (m_threadCount == 0u) {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto &job: m_jobs) {
+            job(primary);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats[0].jobs += m_jobs.size();
+        m_stats[0].recordMs += std::chrono::duration<double, std::milli>(end - start).count();
+        m_doneJobs = m_jobs.size();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_doneJobs == m_jobs.size(); });
+    if (!m_recorded.empty()) {
+        vkCmdExecuteCommands(primary, static_cast<uint32_t>(m_recorded.size()),
+                             m_recorded.data());
+    }
+}
+
+std::vector<CommandRecorder::ThreadStats> CommandRecorder::getThreadStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void CommandRecorder::run(uint32_t thread) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_jobCv.wait(lock, [this]() { return m_stop || m_nextJob < m_jobs.size(); });
+        if (m_stop) {
+            break;
+        }
+        const size_t index = m_nextJob++;
+        Job job = std::move(m_jobs[index]);
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        VkCommandBuffer cmd = record(thread, job);
+        const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        m_recorded[index] = cmd;
+        ++m_stats[thread].jobs;
+        m_stats[thread].recordMs += elapsed.count();
+        if (++m_doneJobs == m_jobs.size()) {
+            m_doneCv.notify_one();
+        }
+    }
+}
+
+VkCommandBuffer CommandRecorder::record(uint32_t thread, Job &job) {
+    // m_frame and m_inheritance only change in beginFrame, after every job of a frame is done
+    FramePool &pool = getPool(thread);
+    if (pool.used == pool.buffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer cmd;
+        VK_CHECK(vkAllocateCommandBuffers(m_core->getDevice(), &allocInfo, &cmd));
+        pool.buffers.push_back(cmd);
+    }
+    VkCommandBuffer cmd = pool.buffers[pool.used++];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &m_inheritance;
+    VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+    job(cmd);
+    VK_CHECK(vkEndCommandBuffer(cmd));
+    return cmd;
+}
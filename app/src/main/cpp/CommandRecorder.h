@@ -0,0 +1,100 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_COMMANDRECORDER_H
+#define ANDROIDVULKAN_COMMANDRECORDER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanCore;
+
+/*
+ * CommandRecorder records the draws of a render pass on a pool of worker threads. Every
+ * worker owns one command pool per frame in flight, so recording never synchronizes on a
+ * pool and a frame's pools are reset as a whole once its submission completed. Jobs start as
+ * soon as they are submitted, the render thread meanwhile records the work before the
+ * render pass and then executes the secondary buffers in submission order.
+ *
+ * With no worker threads the jobs are recorded inline into the primary buffer on the render
+ * thread, which is cheaper for a handful of draws.
+ */
+class CommandRecorder {
+public:
+    using Job = std::function<void(VkCommandBuffer)>;
+
+    struct ThreadStats {
+        uint64_t jobs = 0u;
+        double recordMs = 0.0; // inside jobs, begin and end of the secondary buffers included
+    };
+
+    ~CommandRecorder();
+
+    // threadCount 0 records inline on the thread calling execute
+    void init(VulkanCore &core, uint32_t framesInFlight, uint32_t threadCount);
+
+    // stops the workers, the device must be idle
+    void destroy();
+
+    uint32_t getThreadCount() const {
+        return m_threadCount;
+    }
+
+    // The frame's previous submission completed, its pools are reset. Jobs submitted from now on
+    // continue subpass 0 of renderPass drawing into framebuffer
+    void beginFrame(uint32_t frame, VkRenderPass renderPass, VkFramebuffer framebuffer);
+
+    void submit(Job job);
+
+    // how the primary buffer has to begin the render pass that execute is recorded in
+    VkSubpassContents getSubpassContents() const {
+        return m_threadCount == 0u ? VK_SUBPASS_CONTENTS_INLINE
+                                   : VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+    }
+
+    // inside the render pass: waits for the frame's jobs and executes them in submit order
+    void execute(VkCommandBuffer primary);
+
+    // one entry per worker, a single one for the render thread when recording inline
+    std::vector<ThreadStats> getThreadStats() const;
+
+private:
+    // a worker's pool for one frame in flight, buffers are reused after the pool reset
+    struct FramePool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;
+        uint32_t used = 0u;
+    };
+
+    void run(uint32_t thread);
+
+    VkCommandBuffer record(uint32_t thread, Job &job);
+
+    FramePool &getPool(uint32_t thread) {
+        return m_pools[m_frame * m_threadCount + thread];
+    }
+
+    VulkanCore *m_core = nullptr;
+    uint32_t m_threadCount = 0u;
+    std::vector<FramePool> m_pools; // frame major, worker threads only between beginFrame
+    uint32_t m_frame = 0u;
+    VkCommandBufferInheritanceInfo m_inheritance{};
+
+    std::vector<std::thread> m_workers;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobCv;
+    std::condition_variable m_doneCv;
+    std::vector<Job> m_jobs; // of the current frame
+    std::vector<VkCommandBuffer> m_recorded; // by job index
+    size_t m_nextJob = 0u;
+    size_t m_doneJobs = 0u;
+    std::vector<ThreadStats> m_stats;
+    bool m_stop = false;
+};
+
+#endif //ANDROIDVULKAN_COMMANDRECORDER_H
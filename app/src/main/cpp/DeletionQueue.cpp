@@ -0,0 +1,32 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "DeletionQueue.h"
+
+#include <algorithm>
+#include <cassert>
+
+DeletionQueue::~DeletionQueue() {
+    assert(m_pending.empty()); // leaked objects, flush before the device goes away
+}
+
+void DeletionQueue::push(uint64_t serial, std::function<void()> deleter) {
+    assert(m_pending.empty() || m_pending.back().serial <= serial);
+    m_pending.push_back({serial, std::move(deleter)});
+    m_peakPending = std::max(m_peakPending, m_pending.size());
+}
+
+void DeletionQueue::collect(uint64_t completedSerial) {
+    while (!m_pending.empty() && m_pending.front().serial <= completedSerial) {
+        // popped first, a deleter may push follow-up requests
+        std::function<void()> deleter = std::move(m_pending.front().deleter);
+        m_pending.pop_front();
+        deleter();
+        ++m_deleted;
+    }
+}
+
+void DeletionQueue::flush() {
+    collect(UINT64_MAX);
+}
@@ -0,0 +1,58 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_DELETIONQUEUE_H
+#define ANDROIDVULKAN_DELETIONQUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+/*
+ * DeletionQueue defers the destruction of GPU objects until the work that may still use them
+ * has completed, so replacing a resource never has to drain the device. Every request is
+ * keyed by the GpuTimeline value of the last submission that may reference the object;
+ * collect frees everything up to the value known to have completed. Components that retire
+ * objects on their own (compute outputs, LUT staging) push through a Defer instead of keeping
+ * per-frame lists. Render thread only.
+ */
+class DeletionQueue {
+public:
+    struct Stats {
+        uint64_t deleted = 0u;
+        size_t pending = 0u;
+        size_t peakPending = 0u;
+    };
+
+    // hands a deleter to the owner's queue, keyed with the submission being recorded; lets
+    // components release objects without knowing the timeline
+    using Defer = std::function<void(std::function<void()>)>;
+
+    ~DeletionQueue();
+
+    // serials have to be pushed in non-decreasing order
+    void push(uint64_t serial, std::function<void()> deleter);
+
+    // runs the deleters of every request keyed at or below completedSerial
+    void collect(uint64_t completedSerial);
+
+    // runs every deleter, the device has to be idle
+    void flush();
+
+    Stats getStats() const {
+        return {m_deleted, m_pending.size(), m_peakPending};
+    }
+
+private:
+    struct Request {
+        uint64_t serial;
+        std::function<void()> deleter;
+    };
+
+    std::deque<Request> m_pending;
+    uint64_t m_deleted = 0u;
+    size_t m_peakPending = 0u;
+};
+
+#endif //ANDROIDVULKAN_DELETIONQUEUE_H
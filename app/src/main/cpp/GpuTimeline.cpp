@@ -0,0 +1,148 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "GpuTimeline.h"
+#include "VulkanCore.h"
+
+GpuTimeline::~GpuTimeline() {
+    destroy();
+}
+
+void GpuTimeline::init(VulkanCore &core, VkQueue queue) {
+    destroy();
+    m_core = &core;
+    m_queue = queue;
+    m_submitted = 0u;
+    m_completed = 0u;
+    if (!m_core->hasTimelineSemaphores()) {
+        return;
+    }
+
+    VkDevice device = m_core->getDevice();
+    m_getCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+    m_waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(
+            vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+    assert(m_getCounterValue && m_waitSemaphores);
+
+    VkSemaphoreTypeCreateInfoKHR typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue = 0u;
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    VK_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_semaphore));
+}
+
+void GpuTimeline::destroy() {
+    if (!m_core) {
+        return;
+    }
+    VkDevice device = m_core->getDevice();
+    vkDestroySemaphore(device, m_semaphore, nullptr);
+    m_semaphore = VK_NULL_HANDLE;
+    for (const auto &pending: m_pendingFences) {
+        vkDestroyFence(device, pending.fence, nullptr);
+    }
+    m_pendingFences.clear();
+    for (VkFence fence: m_freeFences) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+    m_freeFences.clear();
+    m_getCounterValue = nullptr;
+    m_waitSemaphores = nullptr;
+    m_core = nullptr;
+}
+
+uint64_t GpuTimeline::submit(const VkSubmitInfo &submitInfo) {
+    assert(m_core);
+    const uint64_t value = m_submitted + 1u;
+    VkSubmitInfo info = submitInfo;
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo{};
+    VkFence fence = VK_NULL_HANDLE;
+    if (m_semaphore) {
+        // signaled after the caller's semaphores, binary ones ignore their value
+        m_signalSemaphores.assign(info.pSignalSemaphores,
+                                  info.pSignalSemaphores + info.signalSemaphoreCount);
+        m_signalSemaphores.push_back(m_semaphore);
+        m_signalValues.assign(m_signalSemaphores.size(), 0u);
+        m_signalValues.back() = value;
+        // only binary semaphores are waited on, those need no wait values
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timelineInfo.pNext = info.pNext;
+        timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(m_signalValues.size());
+        timelineInfo.pSignalSemaphoreValues = m_signalValues.data();
+        info.pNext = &timelineInfo;
+        info.signalSemaphoreCount = static_cast<uint32_t>(m_signalSemaphores.size());
+        info.pSignalSemaphores = m_signalSemaphores.data();
+    } else {
+        retireFences(false);
+        if (m_freeFences.empty()) {
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VK_CHECK(vkCreateFence(m_core->getDevice(), &fenceInfo, nullptr, &fence));
+        } else {
+            fence = m_freeFences.back();
+            m_freeFences.pop_back();
+        }
+    }
+
+    VK_CHECK(m_core->queueSubmit(m_queue, 1, &info, fence));
+    if (fence) {
+        m_pendingFences.push_back({value, fence});
+    }
+    m_submitted = value;
+    return value;
+}
+
+uint64_t GpuTimeline::getCompletedValue() {
+    assert(m_core);
+    if (m_semaphore) {
+        uint64_t value;
+        VK_CHECK(m_getCounterValue(m_core->getDevice(), m_semaphore, &value));
+        m_completed = value;
+    } else {
+        retireFences(false);
+    }
+    return m_completed;
+}
+
+void GpuTimeline::wait(uint64_t value) {
+    assert(m_core && value <= m_submitted);
+    if (value <= m_completed) {
+        return;
+    }
+    if (m_semaphore) {
+        VkSemaphoreWaitInfoKHR waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_semaphore;
+        waitInfo.pValues = &value;
+        VK_CHECK(m_waitSemaphores(m_core->getDevice(), &waitInfo, UINT64_MAX));
+        m_completed = value;
+        return;
+    }
+    while (m_completed < value) {
+        retireFences(true);
+    }
+}
+
+void GpuTimeline::retireFences(bool wait) {
+    VkDevice device = m_core->getDevice();
+    while (!m_pendingFences.empty()) {
+        PendingFence &oldest = m_pendingFences.front();
+        if (wait) {
+            VK_CHECK(vkWaitForFences(device, 1, &oldest.fence, VK_TRUE, UINT64_MAX));
+            wait = false;
+        } else if (vkGetFenceStatus(device, oldest.fence) != VK_SUCCESS) {
+            break;
+        }
+        // a later fence may have signaled first, values still complete in order
+        VK_CHECK(vkResetFences(device, 1, &oldest.fence));
+        m_freeFences.push_back(oldest.fence);
+        m_completed = oldest.value;
+        m_pendingFences.pop_front();
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_GPUTIMELINE_H
+#define ANDROIDVULKAN_GPUTIMELINE_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanCore;
+
+/*
+ * GpuTimeline orders the submissions to one queue by a monotonically increasing value: every
+ * submit signals the next value and the CPU polls or waits for values, so no operation needs
+ * a fence of its own. Backed by a VK_KHR_timeline_semaphore where the device supports it, by
+ * a pool of recycled fences otherwise (Vulkan 1.0 drivers without the extension). Values
+ * complete in submission order. Only the thread submitting to the queue may use it.
+ */
+class GpuTimeline {
+public:
+    ~GpuTimeline();
+
+    void init(VulkanCore &core, VkQueue queue);
+
+    // the queue has to be idle
+    void destroy();
+
+    bool isTimelineSemaphore() const {
+        return m_semaphore != VK_NULL_HANDLE;
+    }
+
+    // Submits through VulkanCore::queueSubmit, binary semaphores of submitInfo are kept.
+    // Returns the value that completes together with the submission
+    uint64_t submit(const VkSubmitInfo &submitInfo);
+
+    // value of the last submission, 0 before the first one
+    uint64_t getSubmittedValue() const {
+        return m_submitted;
+    }
+
+    // polls the GPU, never blocks
+    uint64_t getCompletedValue();
+
+    bool isComplete(uint64_t value) {
+        return value <= m_completed || value <= getCompletedValue();
+    }
+
+    // blocks until value and every value before it completed
+    void wait(uint64_t value);
+
+private:
+    struct PendingFence {
+        uint64_t value;
+        VkFence fence;
+    };
+
+    // fence fallback: recycles the fences of completed submissions, optionally blocking on
+    // the oldest one first
+    void retireFences(bool wait);
+
+    VulkanCore *m_core = nullptr;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE; // null on the fence fallback
+    PFN_vkGetSemaphoreCounterValueKHR m_getCounterValue = nullptr;
+    PFN_vkWaitSemaphoresKHR m_waitSemaphores = nullptr;
+    std::vector<VkSemaphore> m_signalSemaphores; // scratch of submit
+    std::vector<uint64_t> m_signalValues;
+    std::deque<PendingFence> m_pendingFences;
+    std::vector<VkFence> m_freeFences;
+    uint64_t m_submitted = 0u;
+    uint64_t m_completed = 0u; // last value known to have completed
+};
+
+#endif //ANDROIDVULKAN_GPUTIMELINE_H
@@ -0,0 +1,288 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "HsvComputePass.h"
+#include "VulkanCore.h"
+
+#include <chrono>
+
+bool HsvComputePass::isSupported(const VulkanCore &core) {
+    uint32_t familyCount = 0u;
+    vkGetPhysicalDeviceQueueFamilyProperties(core.getPhysDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(core.getPhysDevice(), &familyCount,
+                                             families.data());
+    const auto family = static_cast<uint32_t>(core.getQueueFamily());
+    if (family >= familyCount || !(families[family].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        return false;
+    }
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(core.getPhysDevice(), OUTPUT_FORMAT, &props);
+    // the mip chain of the output is blitted
+    const VkFormatFeatureFlags required =
+            VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (props.optimalTilingFeatures & required) == required;
+}
+
+void HsvComputePass::init(VulkanCore &core, VkPipelineCache pipelineCache,
+                          uint32_t framesInFlight, DeletionQueue::Defer defer) {
+    assert(framesInFlight > 0u && defer);
+    destroy();
+    m_core = &core;
+    m_defer = std::move(defer);
+    VkDevice device = m_core->getDevice();
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_setLayout));
+
+    VkPushConstantRange pushConstant{};
+    pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstant.offset = 0;
+    pushConstant.size = sizeof(m_factors);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstant;
+    VK_CHECK(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout));
+
+    const Platform::AssetView code = m_core->getAssets().map("shaders/hsv_filter.comp.spv");
+    VkShaderModule module = Utils::createShaderModule(device, code.data(), code.size());
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.basePipelineIndex = -1;
+
+    const auto start = std::chrono::steady_clock::now();
+    VK_CHECK(vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, nullptr,
+                                      &m_pipeline));
+    LOGI("HSV compute pipeline created in %.2f ms",
+         std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start).count());
+    vkDestroyShaderModule(device, module, nullptr);
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = framesInFlight;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = framesInFlight;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = framesInFlight;
+    VK_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool));
+
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, m_setLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = framesInFlight;
+    allocInfo.pSetLayouts = layouts.data();
+    m_descriptorSets.resize(framesInFlight);
+    VK_CHECK(vkAllocateDescriptorSets(device, &allocInfo, m_descriptorSets.data()));
+
+    m_descriptorDirty.assign(framesInFlight, true);
+    m_dirty = true;
+}
+
+void HsvComputePass::destroy() {
+    if (!m_core) {
+        return;
+    }
+    VkDevice device = m_core->getDevice();
+    destroyOutput(*m_core, m_output);
+    m_extent = {};
+    m_mipLevels = 1u;
+
+    vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+    vkDestroyPipeline(device, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, m_setLayout, nullptr);
+    m_descriptorPool = VK_NULL_HANDLE;
+    m_descriptorSets.clear();
+    m_descriptorDirty.clear();
+    m_pipeline = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_setLayout = VK_NULL_HANDLE;
+    m_sourceView = VK_NULL_HANDLE;
+    m_sourceSampler = VK_NULL_HANDLE;
+    m_defer = nullptr;
+    m_core = nullptr;
+}
+
+bool HsvComputePass::setSource(VkImageView view, VkSampler sampler, uint32_t width,
+                               uint32_t height) {
+    assert(isReady());
+    if (view != m_sourceView || sampler != m_sourceSampler) {
+        m_sourceView = view;
+        m_sourceSampler = sampler;
+        m_descriptorDirty.assign(m_descriptorDirty.size(), true);
+        m_dirty = true;
+    }
+    if (m_output.image != VK_NULL_HANDLE && m_extent.width == width &&
+        m_extent.height == height) {
+        return false;
+    }
+
+    // frames still in flight may sample the old output
+    if (m_output.image != VK_NULL_HANDLE) {
+        m_defer([core = m_core, output = m_output]() mutable { destroyOutput(*core, output); });
+        m_output = {};
+    }
+    createOutput(width, height);
+    m_descriptorDirty.assign(m_descriptorDirty.size(), true);
+    m_dirty = true;
+    return true;
+}
+
+bool HsvComputePass::record(VkCommandBuffer cmd, uint32_t frame,
+                            const std::array<float, 3> &factors) {
+    assert(isReady() && m_output.image != VK_NULL_HANDLE && frame < m_descriptorSets.size());
+    if (!m_dirty && factors == m_factors) {
+        return false;
+    }
+    m_factors = factors;
+    m_dirty = false;
+
+    if (m_descriptorDirty[frame]) {
+        // the set of this frame is no longer used by the GPU, no update-after-bind needed
+        VkDescriptorImageInfo srcInfo{};
+        srcInfo.sampler = m_sourceSampler;
+        srcInfo.imageView = m_sourceView;
+        srcInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkDescriptorImageInfo dstInfo{};
+        dstInfo.imageView = m_output.storageView;
+        dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = m_descriptorSets[frame];
+        writes[0].dstBinding = 0;
+        writes[0].descriptorCount = 1;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].pImageInfo = &srcInfo;
+        writes[1] = writes[0];
+        writes[1].dstBinding = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        writes[1].pImageInfo = &dstInfo;
+        vkUpdateDescriptorSets(m_core->getDevice(), static_cast<uint32_t>(writes.size()),
+                               writes.data(), 0, nullptr);
+        m_descriptorDirty[frame] = false;
+    }
+
+    // every texel of every level is overwritten, so earlier contents are discarded; frames
+    // submitted before only need to be done sampling it
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    VkImageMemoryBarrier &barrier = barriers[0];
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_output.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    // the levels the blits write
+    barriers[1] = barrier;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 1, m_mipLevels - 1u, 0, 1};
+    const uint32_t barrierCount = m_mipLevels > 1u ? 2u : 1u;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, barrierCount, barriers.data());
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                            &m_descriptorSets[frame], 0, nullptr);
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(m_factors), m_factors.data());
+    vkCmdDispatch(cmd, (m_extent.width + WORKGROUP_SIZE - 1u) / WORKGROUP_SIZE,
+                  (m_extent.height + WORKGROUP_SIZE - 1u) / WORKGROUP_SIZE, 1);
+
+    // generateMipmaps expects every level in TRANSFER_DST_OPTIMAL and leaves them readable
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    Utils::generateMipmaps(cmd, m_output.image, m_extent.width, m_extent.height, m_mipLevels);
+    return true;
+}
+
+void HsvComputePass::createOutput(uint32_t width, uint32_t height) {
+    VkDevice device = m_core->getDevice();
+
+    // the quad shows 12 MP and larger sources minified, without mips the compute path
+    // would alias and fetch full resolution texels again
+    const uint32_t mipLevels = Utils::getMipLevelCount(width, height);
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = OUTPUT_FORMAT;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // transfer source and destination for the mip blits, tools also read level 0 back
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VK_CHECK(vkCreateImage(device, &imageInfo, nullptr, &m_output.image));
+    m_output.mem = m_core->getAllocator().allocateForImage(m_output.image,
+                                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                           VK_IMAGE_TILING_OPTIMAL);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_output.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = OUTPUT_FORMAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    VK_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &m_output.view));
+    viewInfo.subresourceRange.levelCount = 1;
+    VK_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &m_output.storageView));
+    m_extent = {width, height};
+    m_mipLevels = mipLevels;
+}
+
+void HsvComputePass::destroyOutput(VulkanCore &core, Output &output) {
+    if (output.image == VK_NULL_HANDLE) {
+        return;
+    }
+    vkDestroyImageView(core.getDevice(), output.view, nullptr);
+    vkDestroyImageView(core.getDevice(), output.storageView, nullptr);
+    vkDestroyImage(core.getDevice(), output.image, nullptr);
+    core.getAllocator().free(output.mem);
+    output = {};
+}
@@ -0,0 +1,93 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_HSVCOMPUTEPASS_H
+#define ANDROIDVULKAN_HSVCOMPUTEPASS_H
+
+#include "DeletionQueue.h"
+#include "MemoryAllocator.h"
+#include <array>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanCore;
+
+/*
+ * HsvComputePass runs the HSV adjustment of shader.frag as a compute shader over the
+ * source texture in 16x16 tiles and keeps the result in a storage image the graphics
+ * pass samples. Level 0 is written by the shader and the rest of the mip chain is blitted
+ * from it, so the output is minified like the source texture. The dispatch and blits are
+ * only recorded when the factors or the source changed, so an unchanged image costs a
+ * texture fetch per fragment instead of the HSV round trip.
+ */
+class HsvComputePass {
+    static constexpr uint32_t WORKGROUP_SIZE = 16u; // local_size of hsv_filter.comp
+    static constexpr VkFormat OUTPUT_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+    struct Output {
+        VkImage image = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation mem{};
+        VkImageView view = VK_NULL_HANDLE; // every level, sampled
+        VkImageView storageView = VK_NULL_HANDLE; // level 0, storage images have one level
+    };
+
+public:
+    // the graphics queue family has to support compute as well
+    static bool isSupported(const VulkanCore &core);
+
+    // outputs replaced while frames may still sample them are released through defer
+    void init(VulkanCore &core, VkPipelineCache pipelineCache, uint32_t framesInFlight,
+              DeletionQueue::Defer defer);
+
+    void destroy();
+
+    bool isReady() const {
+        return m_pipeline != VK_NULL_HANDLE;
+    }
+
+    // True if the output image was recreated, so descriptors sampling it have to be rewritten
+    bool setSource(VkImageView view, VkSampler sampler, uint32_t width, uint32_t height);
+
+    // records the dispatch if anything changed since the last one, false if it was skipped;
+    // the output is in SHADER_READ_ONLY_OPTIMAL for the fragment stage afterwards
+    bool record(VkCommandBuffer cmd, uint32_t frame, const std::array<float, 3> &factors);
+
+    // forces the next record to dispatch, meant for benchmarks
+    void invalidate() {
+        m_dirty = true;
+    }
+
+    VkImageView getOutputView() const {
+        return m_output.view;
+    }
+
+    VkImage getOutputImage() const {
+        return m_output.image;
+    }
+
+private:
+    void createOutput(uint32_t width, uint32_t height);
+
+    static void destroyOutput(VulkanCore &core, Output &output);
+
+    VulkanCore *m_core = nullptr;
+    DeletionQueue::Defer m_defer;
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> m_descriptorSets; // one per frame in flight
+    std::vector<bool> m_descriptorDirty;
+
+    Output m_output{};
+    VkExtent2D m_extent{};
+    uint32_t m_mipLevels = 1u;
+
+    VkImageView m_sourceView = VK_NULL_HANDLE;
+    VkSampler m_sourceSampler = VK_NULL_HANDLE;
+    std::array<float, 3> m_factors{};
+    bool m_dirty = true;
+};
+
+#endif //ANDROIDVULKAN_HSVCOMPUTEPASS_H
@@ -0,0 +1,390 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "HsvFilter.h"
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// vdivq_f32 and vcvtnq_u32_f32 are aarch64 only, 32 bit arm runs the scalar loop
+#if defined(__aarch64__)
+#define HSV_FILTER_NEON 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define HSV_FILTER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace HsvFilter {
+
+    namespace {
+
+        // factors are already multiplied by 2
+        using RowFn = void (*)(const uint8_t *src, uint8_t *dst, uint32_t width,
+                               const float *scale);
+
+        constexpr float EPSILON = 1e-10f;
+        constexpr float INV_255 = 1.0f / 255.0f;
+
+        inline float clamp01(float value) {
+            return std::min(std::max(value, 0.0f), 1.0f);
+        }
+
+        // UNORM conversion: clamp, scale and round to nearest even like cvtps/vcvtn
+        inline uint8_t toUnorm8(float value) {
+            return static_cast<uint8_t>(std::lrintf(clamp01(value) * 255.0f));
+        }
+
+        // RGBtoHSV, scale, HSVtoRGB on one color, not clamped
+        inline void adjust(float r, float g, float b, const float *scale, float *out) {
+            const bool gLessB = g < b;
+            const float px = gLessB ? b : g;
+            const float py = gLessB ? g : b;
+            const float pz = gLessB ? -1.0f : 0.0f;
+            const float pw = gLessB ? 2.0f / 3.0f : -1.0f / 3.0f;
+            const bool rLessP = r < px;
+            const float qx = rLessP ? px : r;
+            const float qy = py;
+            const float qz = rLessP ? pw : pz;
+            const float qw = rLessP ? r : px;
+            const float c = qx - std::min(qw, qy);
+            const float h = std::fabs((qw - qy) / (6.0f * c + EPSILON) + qz) * scale[0];
+            const float s = c / (qx + EPSILON) * scale[1];
+            const float v = qx * scale[2];
+
+            const float h6 = h * 6.0f;
+            const float hr = clamp01(std::fabs(h6 - 3.0f) - 1.0f);
+            const float hg = clamp01(2.0f - std::fabs(h6 - 2.0f));
+            const float hb = clamp01(2.0f - std::fabs(h6 - 4.0f));
+            out[0] = ((hr - 1.0f) * s + 1.0f) * v;
+            out[1] = ((hg - 1.0f) * s + 1.0f) * v;
+            out[2] = ((hb - 1.0f) * s + 1.0f) * v;
+        }
+
+        void applyScalar(const uint8_t *src, uint8_t *dst, uint32_t width, const float *scale) {
+            for (uint32_t x = 0u; x < width; ++x, src += 4, dst += 4) {
+                float rgb[3];
+                adjust(src[0] * INV_255, src[1] * INV_255, src[2] * INV_255, scale, rgb);
+                const uint8_t a = src[3];
+                dst[0] = toUnorm8(rgb[0]);
+                dst[1] = toUnorm8(rgb[1]);
+                dst[2] = toUnorm8(rgb[2]);
+                dst[3] = a;
+            }
+        }
+
+#if HSV_FILTER_NEON
+        // ((channel - 1) * s + 1) * v stored as UNORM8
+        inline uint32x4_t toUnorm8(float32x4_t channel, float32x4_t s, float32x4_t v) {
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t value = vmulq_f32(
+                    vaddq_f32(vmulq_f32(vsubq_f32(channel, one), s), one), v);
+            return vcvtnq_u32_f32(vmulq_n_f32(
+                    vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), one), 255.0f));
+        }
+
+        void applyNeon(const uint8_t *src, uint8_t *dst, uint32_t width, const float *scale) {
+            const uint32x4_t byteMask = vdupq_n_u32(0xffu);
+            const uint32x4_t alphaMask = vdupq_n_u32(0xff000000u);
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t two = vdupq_n_f32(2.0f);
+            const float32x4_t three = vdupq_n_f32(3.0f);
+            const float32x4_t four = vdupq_n_f32(4.0f);
+            const float32x4_t six = vdupq_n_f32(6.0f);
+            const float32x4_t epsilon = vdupq_n_f32(EPSILON);
+            const float32x4_t scaleH = vdupq_n_f32(scale[0]);
+            const float32x4_t scaleS = vdupq_n_f32(scale[1]);
+            const float32x4_t scaleV = vdupq_n_f32(scale[2]);
+
+            uint32_t x = 0u;
+            for (; x + 4u <= width; x += 4u) {
+                const uint32x4_t px4 = vreinterpretq_u32_u8(vld1q_u8(src + x * 4u));
+                const float32x4_t r = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(px4, byteMask)),
+                                                  INV_255);
+                const float32x4_t g = vmulq_n_f32(
+                        vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px4, 8), byteMask)), INV_255);
+                const float32x4_t b = vmulq_n_f32(
+                        vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px4, 16), byteMask)), INV_255);
+
+                const uint32x4_t gLessB = vcltq_f32(g, b);
+                const float32x4_t px = vbslq_f32(gLessB, b, g);
+                const float32x4_t py = vbslq_f32(gLessB, g, b);
+                const float32x4_t pz = vbslq_f32(gLessB, vdupq_n_f32(-1.0f), zero);
+                const float32x4_t pw = vbslq_f32(gLessB, vdupq_n_f32(2.0f / 3.0f),
+                                                 vdupq_n_f32(-1.0f / 3.0f));
+                const uint32x4_t rLessP = vcltq_f32(r, px);
+                const float32x4_t qx = vbslq_f32(rLessP, px, r);
+                const float32x4_t qz = vbslq_f32(rLessP, pw, pz);
+                const float32x4_t qw = vbslq_f32(rLessP, r, px);
+                const float32x4_t c = vsubq_f32(qx, vminq_f32(qw, py));
+                const float32x4_t h = vmulq_f32(vabsq_f32(vaddq_f32(
+                        vdivq_f32(vsubq_f32(qw, py), vaddq_f32(vmulq_f32(six, c), epsilon)),
+                        qz)), scaleH);
+                const float32x4_t s = vmulq_f32(vdivq_f32(c, vaddq_f32(qx, epsilon)), scaleS);
+                const float32x4_t v = vmulq_f32(qx, scaleV);
+
+                const float32x4_t h6 = vmulq_f32(h, six);
+                const float32x4_t hr = vminq_f32(vmaxq_f32(
+                        vsubq_f32(vabsq_f32(vsubq_f32(h6, three)), one), zero), one);
+                const float32x4_t hg = vminq_f32(vmaxq_f32(
+                        vsubq_f32(two, vabsq_f32(vsubq_f32(h6, two))), zero), one);
+                const float32x4_t hb = vminq_f32(vmaxq_f32(
+                        vsubq_f32(two, vabsq_f32(vsubq_f32(h6, four))), zero), one);
+
+                uint32x4_t out = vandq_u32(px4, alphaMask);
+                out = vorrq_u32(out, toUnorm8(hr, s, v));
+                out = vorrq_u32(out, vshlq_n_u32(toUnorm8(hg, s, v), 8));
+                out = vorrq_u32(out, vshlq_n_u32(toUnorm8(hb, s, v), 16));
+                vst1q_u8(dst + x * 4u, vreinterpretq_u8_u32(out));
+            }
+            applyScalar(src + x * 4u, dst + x * 4u, width - x, scale);
+        }
+#endif
+
+#if HSV_FILTER_X86
+        // a ? b : c per lane
+        __attribute__((target("ssse3")))
+        inline __m128 select(__m128 mask, __m128 b, __m128 c) {
+            return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, c));
+        }
+
+        __attribute__((target("ssse3")))
+        inline __m128 absolute(__m128 value) {
+            return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+        }
+
+        __attribute__((target("ssse3")))
+        inline __m128i toUnorm8(__m128 channel, __m128 s, __m128 v) {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 value = _mm_mul_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_sub_ps(channel, one), s), one), v);
+            return _mm_cvtps_epi32(_mm_mul_ps(
+                    _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), one), _mm_set1_ps(255.0f)));
+        }
+
+        __attribute__((target("ssse3")))
+        void applySsse3(const uint8_t *src, uint8_t *dst, uint32_t width, const float *scale) {
+            const __m128i byteMask = _mm_set1_epi32(0xff);
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+            const __m128 inv255 = _mm_set1_ps(INV_255);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 three = _mm_set1_ps(3.0f);
+            const __m128 four = _mm_set1_ps(4.0f);
+            const __m128 six = _mm_set1_ps(6.0f);
+            const __m128 epsilon = _mm_set1_ps(EPSILON);
+            const __m128 scaleH = _mm_set1_ps(scale[0]);
+            const __m128 scaleS = _mm_set1_ps(scale[1]);
+            const __m128 scaleV = _mm_set1_ps(scale[2]);
+
+            uint32_t x = 0u;
+            for (; x + 4u <= width; x += 4u) {
+                const __m128i px4 = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 4u));
+                const __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(px4, byteMask)),
+                                            inv255);
+                const __m128 g = _mm_mul_ps(
+                        _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px4, 8), byteMask)), inv255);
+                const __m128 b = _mm_mul_ps(
+                        _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px4, 16), byteMask)),
+                        inv255);
+
+                const __m128 gLessB = _mm_cmplt_ps(g, b);
+                const __m128 px = select(gLessB, b, g);
+                const __m128 py = select(gLessB, g, b);
+                const __m128 pz = _mm_and_ps(gLessB, _mm_set1_ps(-1.0f));
+                const __m128 pw = select(gLessB, _mm_set1_ps(2.0f / 3.0f),
+                                         _mm_set1_ps(-1.0f / 3.0f));
+                const __m128 rLessP = _mm_cmplt_ps(r, px);
+                const __m128 qx = select(rLessP, px, r);
+                const __m128 qz = select(rLessP, pw, pz);
+                const __m128 qw = select(rLessP, r, px);
+                const __m128 c = _mm_sub_ps(qx, _mm_min_ps(qw, py));
+                const __m128 h = _mm_mul_ps(absolute(_mm_add_ps(
+                        _mm_div_ps(_mm_sub_ps(qw, py), _mm_add_ps(_mm_mul_ps(six, c), epsilon)),
+                        qz)), scaleH);
+                const __m128 s = _mm_mul_ps(_mm_div_ps(c, _mm_add_ps(qx, epsilon)), scaleS);
+                const __m128 v = _mm_mul_ps(qx, scaleV);
+
+                const __m128 h6 = _mm_mul_ps(h, six);
+                const __m128 hr = _mm_min_ps(_mm_max_ps(
+                        _mm_sub_ps(absolute(_mm_sub_ps(h6, three)), one), zero), one);
+                const __m128 hg = _mm_min_ps(_mm_max_ps(
+                        _mm_sub_ps(two, absolute(_mm_sub_ps(h6, two))), zero), one);
+                const __m128 hb = _mm_min_ps(_mm_max_ps(
+                        _mm_sub_ps(two, absolute(_mm_sub_ps(h6, four))), zero), one);
+
+                __m128i out = _mm_and_si128(px4, alphaMask);
+                out = _mm_or_si128(out, toUnorm8(hr, s, v));
+                out = _mm_or_si128(out, _mm_slli_epi32(toUnorm8(hg, s, v), 8));
+                out = _mm_or_si128(out, _mm_slli_epi32(toUnorm8(hb, s, v), 16));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4u), out);
+            }
+            applyScalar(src + x * 4u, dst + x * 4u, width - x, scale);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256 absolute(__m256 value) {
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i toUnorm8(__m256 channel, __m256 s, __m256 v) {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 value = _mm256_mul_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(channel, one), s), one), v);
+            return _mm256_cvtps_epi32(_mm256_mul_ps(
+                    _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), one),
+                    _mm256_set1_ps(255.0f)));
+        }
+
+        __attribute__((target("avx2")))
+        void applyAvx2(const uint8_t *src, uint8_t *dst, uint32_t width, const float *scale) {
+            const __m256i byteMask = _mm256_set1_epi32(0xff);
+            const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+            const __m256 inv255 = _mm256_set1_ps(INV_255);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 two = _mm256_set1_ps(2.0f);
+            const __m256 three = _mm256_set1_ps(3.0f);
+            const __m256 four = _mm256_set1_ps(4.0f);
+            const __m256 six = _mm256_set1_ps(6.0f);
+            const __m256 epsilon = _mm256_set1_ps(EPSILON);
+            const __m256 scaleH = _mm256_set1_ps(scale[0]);
+            const __m256 scaleS = _mm256_set1_ps(scale[1]);
+            const __m256 scaleV = _mm256_set1_ps(scale[2]);
+
+            uint32_t x = 0u;
+            for (; x + 8u <= width; x += 8u) {
+                const __m256i px8 = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(src + x * 4u));
+                const __m256 r = _mm256_mul_ps(
+                        _mm256_cvtepi32_ps(_mm256_and_si256(px8, byteMask)), inv255);
+                const __m256 g = _mm256_mul_ps(_mm256_cvtepi32_ps(
+                        _mm256_and_si256(_mm256_srli_epi32(px8, 8), byteMask)), inv255);
+                const __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(
+                        _mm256_and_si256(_mm256_srli_epi32(px8, 16), byteMask)), inv255);
+
+                // blendv picks its second operand where the mask is set
+                const __m256 gLessB = _mm256_cmp_ps(g, b, _CMP_LT_OQ);
+                const __m256 px = _mm256_blendv_ps(g, b, gLessB);
+                const __m256 py = _mm256_blendv_ps(b, g, gLessB);
+                const __m256 pz = _mm256_and_ps(gLessB, _mm256_set1_ps(-1.0f));
+                const __m256 pw = _mm256_blendv_ps(_mm256_set1_ps(-1.0f / 3.0f),
+                                                   _mm256_set1_ps(2.0f / 3.0f), gLessB);
+                const __m256 rLessP = _mm256_cmp_ps(r, px, _CMP_LT_OQ);
+                const __m256 qx = _mm256_blendv_ps(r, px, rLessP);
+                const __m256 qz = _mm256_blendv_ps(pz, pw, rLessP);
+                const __m256 qw = _mm256_blendv_ps(px, r, rLessP);
+                const __m256 c = _mm256_sub_ps(qx, _mm256_min_ps(qw, py));
+                const __m256 h = _mm256_mul_ps(absolute(_mm256_add_ps(_mm256_div_ps(
+                        _mm256_sub_ps(qw, py), _mm256_add_ps(_mm256_mul_ps(six, c), epsilon)),
+                        qz)), scaleH);
+                const __m256 s = _mm256_mul_ps(_mm256_div_ps(c, _mm256_add_ps(qx, epsilon)),
+                                               scaleS);
+                const __m256 v = _mm256_mul_ps(qx, scaleV);
+
+                const __m256 h6 = _mm256_mul_ps(h, six);
+                const __m256 hr = _mm256_min_ps(_mm256_max_ps(
+                        _mm256_sub_ps(absolute(_mm256_sub_ps(h6, three)), one), zero), one);
+                const __m256 hg = _mm256_min_ps(_mm256_max_ps(
+                        _mm256_sub_ps(two, absolute(_mm256_sub_ps(h6, two))), zero), one);
+                const __m256 hb = _mm256_min_ps(_mm256_max_ps(
+                        _mm256_sub_ps(two, absolute(_mm256_sub_ps(h6, four))), zero), one);
+
+                __m256i out = _mm256_and_si256(px8, alphaMask);
+                out = _mm256_or_si256(out, toUnorm8(hr, s, v));
+                out = _mm256_or_si256(out, _mm256_slli_epi32(toUnorm8(hg, s, v), 8));
+                out = _mm256_or_si256(out, _mm256_slli_epi32(toUnorm8(hb, s, v), 16));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4u), out);
+            }
+            applyScalar(src + x * 4u, dst + x * 4u, width - x, scale);
+        }
+#endif
+
+        RowFn getRowFn() {
+            switch (PixelKernels::getIsa()) {
+#if HSV_FILTER_NEON
+                case PixelKernels::Isa::Neon:
+                    return applyNeon;
+#endif
+#if HSV_FILTER_X86
+                case PixelKernels::Isa::Ssse3:
+                    return applySsse3;
+                case PixelKernels::Isa::Avx2:
+                    return applyAvx2;
+#endif
+                default:
+                    return applyScalar;
+            }
+        }
+
+        std::array<float, 3> getScale(const std::array<float, 3> &factors) {
+            // fragHSVFactors.rgb * 2.0
+            return {factors[0] * 2.0f, factors[1] * 2.0f, factors[2] * 2.0f};
+        }
+
+    }  // namespace
+
+    void applyRow(const uint8_t *src, uint8_t *dst, uint32_t width,
+                  const std::array<float, 3> &factors) {
+        getRowFn()(src, dst, width, getScale(factors).data());
+    }
+
+    void apply(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+               uint32_t width, uint32_t height, const std::array<float, 3> &factors,
+               uint32_t threadCount) {
+        if (height == 0u) {
+            return;
+        }
+        const RowFn fn = getRowFn();
+        const std::array<float, 3> scale = getScale(factors);
+        if (threadCount == 0u) {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        threadCount = std::min(threadCount, height);
+
+        const auto applyBand = [&](uint32_t first, uint32_t last) {
+            for (uint32_t y = first; y < last; ++y) {
+                fn(src + y * srcPitch, dst + y * dstPitch, width, scale.data());
+            }
+        };
+        const uint32_t bandRows = (height + threadCount - 1u) / threadCount;
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1u);
+        for (uint32_t band = 1u; band < threadCount; ++band) {
+            workers.emplace_back(applyBand, std::min(band * bandRows, height),
+                                 std::min((band + 1u) * bandRows, height));
+        }
+        applyBand(0u, std::min(bandRows, height));
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    void bakeLut(const std::array<float, 3> &factors, uint32_t size, uint8_t *dst) {
+        assert(size >= 2u);
+        const std::array<float, 3> scale = getScale(factors);
+        const float step = 1.0f / static_cast<float>(size - 1u);
+        float rgb[3];
+        for (uint32_t b = 0u; b < size; ++b) {
+            for (uint32_t g = 0u; g < size; ++g) {
+                for (uint32_t r = 0u; r < size; ++r, dst += 4) {
+                    adjust(r * step, g * step, b * step, scale.data(), rgb);
+                    dst[0] = toUnorm8(rgb[0]);
+                    dst[1] = toUnorm8(rgb[1]);
+                    dst[2] = toUnorm8(rgb[2]);
+                    dst[3] = 255u;
+                }
+            }
+        }
+    }
+
+}  // namespace HsvFilter
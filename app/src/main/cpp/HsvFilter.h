@@ -0,0 +1,36 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_HSVFILTER_H
+#define ANDROIDVULKAN_HSVFILTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * CPU version of the HSV adjustment in shader.frag and hsv_filter.comp, used to validate
+ * GPU output and to process images where Vulkan is not available. Factors have the
+ * PushConstant_Data semantics: hue, saturation and value are scaled by factor * 2, so 0.5
+ * keeps a channel as it is. The float math follows the shaders operation by operation and
+ * is rounded like a UNORM8 store. Runs on the instruction set selected in PixelKernels.
+ */
+namespace HsvFilter {
+
+    // one row of RGBA8 pixels, alpha is passed through; src may equal dst
+    void applyRow(const uint8_t *src, uint8_t *dst, uint32_t width,
+                  const std::array<float, 3> &factors);
+
+    // rows are split into contiguous bands over threadCount threads, 0 uses every core
+    void apply(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+               uint32_t width, uint32_t height, const std::array<float, 3> &factors,
+               uint32_t threadCount = 1u);
+
+    // Samples the filter on a size^3 lattice spanning [0, 1] per channel into RGBA8 texels,
+    // red varying fastest, as laid out in a 3D image. Alpha is 255; dst is only written
+    void bakeLut(const std::array<float, 3> &factors, uint32_t size, uint8_t *dst);
+
+}  // namespace HsvFilter
+
+#endif //ANDROIDVULKAN_HSVFILTER_H
@@ -0,0 +1,101 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "HsvLut.h"
+#include "HsvFilter.h"
+#include "VulkanCore.h"
+
+void HsvLut::init(VulkanCore &core, StagingPool &stagingPool, DeletionQueue::Defer defer) {
+    assert(defer);
+    destroy();
+    m_core = &core;
+    m_stagingPool = &stagingPool;
+    m_defer = std::move(defer);
+    VkDevice device = m_core->getDevice();
+
+    // linear filtering of RGBA8 is mandatory for optimal tiling, 3D included
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_3D;
+    imageInfo.format = FORMAT;
+    imageInfo.extent = {SIZE, SIZE, SIZE};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VK_CHECK(vkCreateImage(device, &imageInfo, nullptr, &m_image));
+    m_mem = m_core->getAllocator().allocateForImage(m_image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                    VK_IMAGE_TILING_OPTIMAL);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+    viewInfo.format = FORMAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    VK_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &m_view));
+
+    // the shader maps colors onto texel centers, clamping keeps the edges exact
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0f;
+    VK_CHECK(vkCreateSampler(device, &samplerInfo, nullptr, &m_sampler));
+
+    m_baked = false;
+}
+
+void HsvLut::destroy() {
+    if (!m_core) {
+        return;
+    }
+    VkDevice device = m_core->getDevice();
+    vkDestroySampler(device, m_sampler, nullptr);
+    vkDestroyImageView(device, m_view, nullptr);
+    vkDestroyImage(device, m_image, nullptr);
+    m_core->getAllocator().free(m_mem);
+    m_sampler = VK_NULL_HANDLE;
+    m_view = VK_NULL_HANDLE;
+    m_image = VK_NULL_HANDLE;
+    m_stagingPool = nullptr;
+    m_defer = nullptr;
+    m_core = nullptr;
+}
+
+bool HsvLut::record(VkCommandBuffer cmd, const std::array<float, 3> &factors) {
+    assert(m_core);
+    if (m_baked && factors == m_factors) {
+        return false;
+    }
+    m_factors = factors;
+    m_baked = true;
+
+    const VkDeviceSize size = VkDeviceSize(SIZE) * SIZE * SIZE * 4u;
+    StagingPool::Buffer staging = m_stagingPool->acquire(size);
+    HsvFilter::bakeLut(factors, SIZE, static_cast<uint8_t *>(staging.data()));
+
+    // the whole lattice is replaced, earlier frames only need to be done sampling it
+    Utils::setImageLayout(cmd, m_image, VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {SIZE, SIZE, SIZE};
+    vkCmdCopyBufferToImage(cmd, staging.buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &region);
+    // read by the copy until the submission completes
+    m_defer([pool = m_stagingPool, staging]() mutable { pool->release(staging); });
+    Utils::setImageLayout(cmd, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    return true;
+}
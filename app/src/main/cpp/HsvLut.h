@@ -0,0 +1,62 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_HSVLUT_H
+#define ANDROIDVULKAN_HSVLUT_H
+
+#include "DeletionQueue.h"
+#include "MemoryAllocator.h"
+#include "StagingPool.h"
+#include <array>
+#include <vulkan/vulkan.h>
+
+class VulkanCore;
+
+/*
+ * HsvLut bakes the HSV adjustment into a 33^3 RGBA8 3D image the fragment shader looks
+ * colors up in with one trilinear fetch, so the per pixel cost no longer depends on the
+ * filter. The lattice is baked by HsvFilter on the render thread when the factors change
+ * (about a millisecond) and uploaded through the frame's command buffer. Other color
+ * adjustments can be folded into the same lattice.
+ *
+ * Hue wraps at red, so the filter jumps across g == b under a red maximum and interpolating
+ * over that seam would be far off. shader.frag filters colors in the lattice cells touching
+ * it exactly instead; hsv_filter_golden bounds the error everywhere else.
+ */
+class HsvLut {
+public:
+    static constexpr uint32_t SIZE = 33u; // lattice points per axis
+    static constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+    // the staging buffer of every upload is released through defer
+    void init(VulkanCore &core, StagingPool &stagingPool, DeletionQueue::Defer defer);
+
+    void destroy();
+
+    // Bakes and records the upload if the factors changed since the last one, false if it
+    // was skipped; the image is in SHADER_READ_ONLY_OPTIMAL for the fragment stage afterwards
+    bool record(VkCommandBuffer cmd, const std::array<float, 3> &factors);
+
+    VkImageView getView() const {
+        return m_view;
+    }
+
+    VkSampler getSampler() const {
+        return m_sampler;
+    }
+
+private:
+    VulkanCore *m_core = nullptr;
+    StagingPool *m_stagingPool = nullptr;
+    DeletionQueue::Defer m_defer;
+    VkImage m_image = VK_NULL_HANDLE;
+    MemoryAllocator::Allocation m_mem{};
+    VkImageView m_view = VK_NULL_HANDLE;
+    VkSampler m_sampler = VK_NULL_HANDLE;
+
+    std::array<float, 3> m_factors{};
+    bool m_baked = false;
+};
+
+#endif //ANDROIDVULKAN_HSVLUT_H
@@ -0,0 +1,118 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "Ktx2.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Ktx2 {
+
+    bool getFormatInfo(VkFormat format, FormatInfo &info) {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                info = {1u, 1u, 4u};
+                return true;
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                info = {4u, 4u, 8u};
+                return true;
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+            case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+            case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+                info = {4u, 4u, 16u};
+                return true;
+            case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+            case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+                info = {6u, 6u, 16u};
+                return true;
+            case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+            case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+                info = {8u, 8u, 16u};
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    size_t getLevelSize(const FormatInfo &info, uint32_t width, uint32_t height) {
+        const size_t blocksX = (width + info.blockWidth - 1u) / info.blockWidth;
+        const size_t blocksY = (height + info.blockHeight - 1u) / info.blockHeight;
+        return blocksX * blocksY * info.blockBytes;
+    }
+
+    bool isKtx2(const uint8_t *data, size_t size) {
+        return size >= sizeof(Header) && !memcmp(data, IDENTIFIER.data(), IDENTIFIER.size());
+    }
+
+    bool parse(const uint8_t *data, size_t size, Texture &texture) {
+        if (!isKtx2(data, size)) {
+            LOGE("KTX2: bad identifier");
+            return false;
+        }
+        Header header;
+        memcpy(&header, data, sizeof(header));
+
+        FormatInfo info;
+        const VkFormat format = static_cast<VkFormat>(header.vkFormat);
+        if (!getFormatInfo(format, info)) {
+            LOGE("KTX2: unsupported vkFormat %u", header.vkFormat);
+            return false;
+        }
+        if (header.supercompressionScheme != 0u) {
+            LOGE("KTX2: supercompression scheme %u is not supported",
+                 header.supercompressionScheme);
+            return false;
+        }
+        if (header.pixelWidth == 0u || header.pixelHeight == 0u || header.pixelDepth > 1u ||
+            header.layerCount > 1u || header.faceCount != 1u) {
+            LOGE("KTX2: only single 2D images are supported");
+            return false;
+        }
+        const uint32_t fullChain = Utils::getMipLevelCount(header.pixelWidth, header.pixelHeight);
+        const uint32_t levelCount = std::max(header.levelCount, 1u);
+        if (levelCount > fullChain ||
+            sizeof(Header) + levelCount * sizeof(LevelIndex) > size) {
+            LOGE("KTX2: bad level count %u", header.levelCount);
+            return false;
+        }
+
+        texture.format = format;
+        texture.width = header.pixelWidth;
+        texture.height = header.pixelHeight;
+        texture.generateMips = header.levelCount == 0u;
+        texture.levels.clear();
+        for (uint32_t level = 0u; level < levelCount; ++level) {
+            LevelIndex index;
+            memcpy(&index, data + sizeof(Header) + level * sizeof(LevelIndex), sizeof(index));
+
+            const uint32_t width = std::max(header.pixelWidth >> level, 1u);
+            const uint32_t height = std::max(header.pixelHeight >> level, 1u);
+            const size_t expected = getLevelSize(info, width, height);
+            if (index.byteLength != expected || index.byteOffset > size ||
+                index.byteLength > size - index.byteOffset) {
+                LOGE("KTX2: level %u is %llu bytes at %llu, expected %zu", level,
+                     static_cast<unsigned long long>(index.byteLength),
+                     static_cast<unsigned long long>(index.byteOffset), expected);
+                return false;
+            }
+            texture.levels.push_back({data + index.byteOffset, expected, width, height});
+        }
+        return true;
+    }
+
+}  // namespace Ktx2
@@ -0,0 +1,85 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_KTX2_H
+#define ANDROIDVULKAN_KTX2_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/*
+ * Minimal reader for KTX2 containers holding 2D textures with their mip chain stored
+ * as GPU ready blocks (ETC2, ASTC, BC or plain RGBA8). Supercompressed payloads (Basis,
+ * zstd), arrays, cube maps and 3D textures are rejected; tools/ktx2_packer writes them.
+ */
+namespace Ktx2 {
+
+    constexpr std::array<uint8_t, 12> IDENTIFIER = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB,
+                                                    '\r', '\n', 0x1A, '\n'};
+
+    struct Header {
+        uint8_t identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+    static_assert(sizeof(Header) == 80, "KTX2 header is 80 bytes");
+
+    // follows the header, one entry per mip level starting with the base level
+    struct LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    struct FormatInfo {
+        uint32_t blockWidth;
+        uint32_t blockHeight;
+        uint32_t blockBytes;
+    };
+
+    struct Level {
+        const uint8_t *data;
+        size_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct Texture {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        bool generateMips = false; // levelCount 0 in the file asks the loader for a full chain
+        std::vector<Level> levels; // point into the parsed memory
+    };
+
+    // block layout of the formats the engine ingests, false for anything else
+    bool getFormatInfo(VkFormat format, FormatInfo &info);
+
+    // bytes of a tightly packed level of the given size
+    size_t getLevelSize(const FormatInfo &info, uint32_t width, uint32_t height);
+
+    bool isKtx2(const uint8_t *data, size_t size);
+
+    // validates the container, logs and returns false if it cannot be uploaded as is
+    bool parse(const uint8_t *data, size_t size, Texture &texture);
+
+}  // namespace Ktx2
+
+#endif //ANDROIDVULKAN_KTX2_H
@@ -0,0 +1,282 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "MemoryAllocator.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+namespace {
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1u) / alignment * alignment;
+    }
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    destroy();
+}
+
+void MemoryAllocator::init(VkPhysicalDevice physDevice, VkDevice device) {
+    assert(physDevice && device);
+    destroy();
+
+    m_physDevice = physDevice;
+    m_device = device;
+    vkGetPhysicalDeviceMemoryProperties(physDevice, &m_memProps);
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physDevice, &props);
+    m_bufferImageGranularity = std::max<VkDeviceSize>(props.limits.bufferImageGranularity, 1u);
+}
+
+void MemoryAllocator::destroy() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &block: m_blocks) {
+        if (block.memory != VK_NULL_HANDLE) {
+            if (block.allocationCount > 0u) {
+                LOGE("Memory block of type %u released with %u live allocations",
+                     block.memoryType, block.allocationCount);
+            }
+            vkFreeMemory(m_device, block.memory, nullptr);
+        }
+    }
+    m_blocks.clear();
+    m_dedicatedBytes = 0u;
+    m_dedicatedCount = 0u;
+}
+
+VkDeviceSize MemoryAllocator::getBlockSize(uint32_t memoryType) const {
+    // small heaps (e.g. the 256MB host visible device local window) get smaller blocks
+    const VkDeviceSize heapSize = m_memProps.memoryHeaps[m_memProps.memoryTypes[memoryType].heapIndex].size;
+    return std::min(DEFAULT_BLOCK_SIZE, alignUp(heapSize / 8u, 1024u * 1024u));
+}
+
+VkDeviceMemory MemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType,
+                                                     void **mapped) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory;
+    VK_CHECK(vkAllocateMemory(m_device, &allocInfo, nullptr, &memory));
+
+    *mapped = nullptr;
+    if (m_memProps.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        VK_CHECK(vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, mapped));
+    }
+    return memory;
+}
+
+bool MemoryAllocator::suballocate(Block &block, VkDeviceSize size, VkDeviceSize alignment,
+                                  VkDeviceSize &offset) {
+    // first fit, the list is short since neighbouring ranges are merged on free
+    for (size_t i = 0u; i < block.freeList.size(); ++i) {
+        FreeRange range = block.freeList[i];
+        const VkDeviceSize alignedOffset = alignUp(range.offset, alignment);
+        const VkDeviceSize rangeEnd = range.offset + range.size;
+        if (alignedOffset + size > rangeEnd) {
+            continue;
+        }
+
+        block.freeList.erase(block.freeList.begin() + i);
+        // tail first so the list stays sorted after both inserts
+        if (alignedOffset + size < rangeEnd) {
+            block.freeList.insert(block.freeList.begin() + i,
+                                  {alignedOffset + size, rangeEnd - alignedOffset - size});
+        }
+        if (alignedOffset > range.offset) {
+            block.freeList.insert(block.freeList.begin() + i,
+                                  {range.offset, alignedOffset - range.offset});
+        }
+        offset = alignedOffset;
+        return true;
+    }
+    return false;
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocate(const VkMemoryRequirements &requirements,
+                                                      VkMemoryPropertyFlags properties,
+                                                      ResourceKind kind) {
+    assert(m_device);
+    const uint32_t memoryType = Utils::findMemoryType(m_physDevice, requirements.memoryTypeBits,
+                                                      properties);
+    if (memoryType == UINT_MAX) {
+        LOGE("No memory type for bits 0x%x and properties 0x%x", requirements.memoryTypeBits,
+             properties);
+        abort();
+    }
+
+    Allocation allocation{};
+    allocation.memoryType = memoryType;
+    allocation.size = requirements.size;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const VkDeviceSize blockSize = getBlockSize(memoryType);
+    if (requirements.size > blockSize / 2u) {
+        // very large images get their own memory object instead of fragmenting a block
+        allocation.memory = allocateDeviceMemory(requirements.size, memoryType,
+                                                 &allocation.mapped);
+        m_dedicatedBytes += requirements.size;
+        ++m_dedicatedCount;
+        return allocation;
+    }
+
+    // blocks are segregated by resource kind when the device has a bufferImageGranularity,
+    // so linear and optimal resources never share a granularity page
+    const bool segregate = m_bufferImageGranularity > 1u;
+    int32_t freeSlot = -1;
+    for (size_t i = 0u; i < m_blocks.size(); ++i) {
+        Block &block = m_blocks[i];
+        if (block.memory == VK_NULL_HANDLE) {
+            freeSlot = static_cast<int32_t>(i);
+            continue;
+        }
+        if (block.memoryType != memoryType || (segregate && block.kind != kind)) {
+            continue;
+        }
+        if (suballocate(block, requirements.size, requirements.alignment, allocation.offset)) {
+            block.used += requirements.size;
+            ++block.allocationCount;
+            allocation.memory = block.memory;
+            allocation.mapped = block.mapped ? static_cast<uint8_t *>(block.mapped) +
+                                               allocation.offset : nullptr;
+            allocation.blockIndex = static_cast<int32_t>(i);
+            return allocation;
+        }
+    }
+
+    Block block;
+    block.size = blockSize;
+    block.memoryType = memoryType;
+    block.kind = kind;
+    block.memory = allocateDeviceMemory(blockSize, memoryType, &block.mapped);
+    block.freeList.push_back({0u, blockSize});
+    LOGD("Allocated memory block of %llu bytes, type %u",
+         static_cast<unsigned long long>(blockSize), memoryType);
+
+    if (freeSlot < 0) {
+        freeSlot = static_cast<int32_t>(m_blocks.size());
+        m_blocks.push_back({});
+    }
+    Block &newBlock = m_blocks[freeSlot];
+    newBlock = std::move(block);
+
+    const bool fits = suballocate(newBlock, requirements.size, requirements.alignment,
+                                  allocation.offset);
+    assert(fits);
+    newBlock.used += requirements.size;
+    ++newBlock.allocationCount;
+    allocation.memory = newBlock.memory;
+    allocation.mapped = newBlock.mapped ? static_cast<uint8_t *>(newBlock.mapped) +
+                                          allocation.offset : nullptr;
+    allocation.blockIndex = freeSlot;
+    return allocation;
+}
+
+void MemoryAllocator::free(Allocation &allocation) {
+    if (allocation.memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (allocation.blockIndex < 0) {
+        vkFreeMemory(m_device, allocation.memory, nullptr);
+        m_dedicatedBytes -= allocation.size;
+        --m_dedicatedCount;
+        allocation = {};
+        return;
+    }
+
+    Block &block = m_blocks[allocation.blockIndex];
+    assert(block.memory == allocation.memory);
+
+    // insert sorted and merge with the neighbours
+    auto it = std::lower_bound(block.freeList.begin(), block.freeList.end(), allocation.offset,
+                               [](const FreeRange &range, VkDeviceSize offset) {
+                                   return range.offset < offset;
+                               });
+    it = block.freeList.insert(it, {allocation.offset, allocation.size});
+    if (it + 1 != block.freeList.end() && it->offset + it->size == (it + 1)->offset) {
+        it->size += (it + 1)->size;
+        block.freeList.erase(it + 1);
+    }
+    if (it != block.freeList.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+        (it - 1)->size += it->size;
+        block.freeList.erase(it);
+    }
+
+    block.used -= allocation.size;
+    --block.allocationCount;
+
+    // keep one empty block per memory type around to avoid allocation ping-pong
+    if (block.allocationCount == 0u) {
+        const bool hasSibling = std::any_of(m_blocks.begin(), m_blocks.end(),
+                                            [&block](const Block &other) {
+                                                return &other != &block &&
+                                                       other.memory != VK_NULL_HANDLE &&
+                                                       other.memoryType == block.memoryType;
+                                            });
+        if (hasSibling) {
+            vkFreeMemory(m_device, block.memory, nullptr);
+            block = {};
+        }
+    }
+    allocation = {};
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocateForBuffer(VkBuffer buffer,
+                                                               VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
+
+    Allocation allocation = allocate(memRequirements, properties, ResourceKind::Linear);
+    VK_CHECK(vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset));
+    return allocation;
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocateForImage(VkImage image,
+                                                              VkMemoryPropertyFlags properties,
+                                                              VkImageTiling tiling) {
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(m_device, image, &memRequirements);
+
+    Allocation allocation = allocate(memRequirements, properties,
+                                     tiling == VK_IMAGE_TILING_OPTIMAL ? ResourceKind::Optimal
+                                                                       : ResourceKind::Linear);
+    VK_CHECK(vkBindImageMemory(m_device, image, allocation.memory, allocation.offset));
+    return allocation;
+}
+
+MemoryAllocator::Stats MemoryAllocator::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats{};
+    for (const auto &block: m_blocks) {
+        if (block.memory == VK_NULL_HANDLE) {
+            continue;
+        }
+        stats.usedBytes += block.used;
+        stats.reservedBytes += block.size;
+        stats.allocationCount += block.allocationCount;
+        ++stats.blockCount;
+    }
+    stats.usedBytes += m_dedicatedBytes;
+    stats.reservedBytes += m_dedicatedBytes;
+    stats.allocationCount += m_dedicatedCount;
+    stats.dedicatedCount = m_dedicatedCount;
+    return stats;
+}
+
+void MemoryAllocator::logStats() const {
+    const Stats stats = getStats();
+    LOGI("GPU memory: %llu KB used of %llu KB reserved, %u allocations in %u blocks, %u dedicated",
+         static_cast<unsigned long long>(stats.usedBytes / 1024u),
+         static_cast<unsigned long long>(stats.reservedBytes / 1024u),
+         stats.allocationCount, stats.blockCount, stats.dedicatedCount);
+}
@@ -0,0 +1,102 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_MEMORYALLOCATOR_H
+#define ANDROIDVULKAN_MEMORYALLOCATOR_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/*
+ * MemoryAllocator sub-allocates buffers and images from large per-memory-type blocks
+ * instead of calling vkAllocateMemory for every resource (drivers cap
+ * maxMemoryAllocationCount and each call is slow).
+ * Host visible blocks are mapped once for their whole lifetime.
+ */
+class MemoryAllocator {
+public:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024ull * 1024ull;
+
+    // bufferImageGranularity only matters between linear and optimal resources
+    enum class ResourceKind : uint8_t {
+        Linear,  // buffers and linear images
+        Optimal  // optimally tiled images
+    };
+
+    struct Allocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0u;
+        VkDeviceSize size = 0u;
+        void *mapped = nullptr; // host address of offset, null for device only memory
+        uint32_t memoryType = UINT32_MAX;
+        int32_t blockIndex = -1; // -1 for dedicated allocations
+    };
+
+    struct Stats {
+        VkDeviceSize usedBytes = 0u;
+        VkDeviceSize reservedBytes = 0u;
+        uint32_t blockCount = 0u;
+        uint32_t allocationCount = 0u;
+        uint32_t dedicatedCount = 0u;
+    };
+
+    ~MemoryAllocator();
+
+    void init(VkPhysicalDevice physDevice, VkDevice device);
+
+    void destroy();
+
+    Allocation allocate(const VkMemoryRequirements &requirements,
+                        VkMemoryPropertyFlags properties, ResourceKind kind);
+
+    void free(Allocation &allocation);
+
+    // allocate + bind helpers
+    Allocation allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties);
+
+    Allocation allocateForImage(VkImage image, VkMemoryPropertyFlags properties,
+                                VkImageTiling tiling);
+
+    Stats getStats() const;
+
+    void logStats() const;
+
+private:
+    struct FreeRange {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0u;
+        VkDeviceSize used = 0u;
+        void *mapped = nullptr;
+        uint32_t memoryType = UINT32_MAX;
+        uint32_t allocationCount = 0u;
+        ResourceKind kind = ResourceKind::Linear;
+        std::vector<FreeRange> freeList; // sorted by offset, neighbours are always merged
+    };
+
+    VkDeviceSize getBlockSize(uint32_t memoryType) const;
+
+    VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, void **mapped);
+
+    bool suballocate(Block &block, VkDeviceSize size, VkDeviceSize alignment,
+                     VkDeviceSize &offset);
+
+    VkPhysicalDevice m_physDevice = nullptr;
+    VkDevice m_device = nullptr;
+    VkPhysicalDeviceMemoryProperties m_memProps{};
+    VkDeviceSize m_bufferImageGranularity = 1u;
+
+    std::vector<Block> m_blocks; // released blocks keep their slot so indices stay valid
+    VkDeviceSize m_dedicatedBytes = 0u;
+    uint32_t m_dedicatedCount = 0u;
+    mutable std::mutex m_mutex;
+};
+
+#endif //ANDROIDVULKAN_MEMORYALLOCATOR_H
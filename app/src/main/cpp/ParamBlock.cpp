@@ -0,0 +1,58 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "ParamBlock.h"
+
+#include <cstring>
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free,
+              "the buffer words are accessed as atomics in place");
+
+bool ParamBlock::attach(void *memory, size_t size) {
+    if (!memory || size < SIZE ||
+        reinterpret_cast<uintptr_t>(memory) % alignof(std::atomic<uint32_t>) != 0u) {
+        return false;
+    }
+    m_words.store(static_cast<std::atomic<uint32_t> *>(memory), std::memory_order_release);
+    return true;
+}
+
+bool ParamBlock::poll(std::array<float, 3> &factors) {
+    if (!isAttached()) {
+        return false;
+    }
+    // seqlock read: the words in between only count if the sequence was even and unchanged
+    const uint32_t sequence = word(SEQUENCE).load(std::memory_order_acquire);
+    if (sequence == m_readSequence || sequence % 2u != 0u) {
+        return false;
+    }
+    std::array<uint32_t, 3> bits{};
+    bits[0] = word(HUE).load(std::memory_order_relaxed);
+    bits[1] = word(SATURATION).load(std::memory_order_relaxed);
+    bits[2] = word(INTENSITY).load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (word(SEQUENCE).load(std::memory_order_relaxed) != sequence) {
+        return false;
+    }
+    memcpy(factors.data(), bits.data(), sizeof(bits));
+    m_readSequence = sequence;
+    return true;
+}
+
+bool ParamBlock::enterIdle() {
+    if (!isAttached()) {
+        return true;
+    }
+    // store then load, both sequentially consistent: either Kotlin sees the flag and wakes
+    // the loop, or the loop sees the new sequence here
+    word(NATIVE_IDLE).store(1u, std::memory_order_seq_cst);
+    return word(SEQUENCE).load(std::memory_order_seq_cst) == m_readSequence;
+}
+
+void ParamBlock::leaveIdle() {
+    if (isAttached()) {
+        word(NATIVE_IDLE).store(0u, std::memory_order_relaxed);
+    }
+}
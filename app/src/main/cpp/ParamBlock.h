@@ -0,0 +1,67 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PARAMBLOCK_H
+#define ANDROIDVULKAN_PARAMBLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * ParamBlock reads the filter parameters Kotlin writes into a direct ByteBuffer shared
+ * with native code (ParamBlock.kt), so slider moves cost no JNI transition. The layout is
+ * a sequence of native endian 32 bit words:
+ *   SEQUENCE     seqlock counter, odd while Kotlin writes
+ *   NATIVE_IDLE  1 while the render loop blocks, Kotlin then calls wakeRenderLoop once
+ *   HUE, SATURATION, INTENSITY  float factors
+ * One thread writes the buffer and one thread polls it.
+ */
+class ParamBlock {
+public:
+    enum Word : uint32_t {
+        SEQUENCE = 0u,
+        NATIVE_IDLE,
+        HUE,
+        SATURATION,
+        INTENSITY,
+        WORD_COUNT
+    };
+
+    static constexpr size_t SIZE = WORD_COUNT * sizeof(uint32_t);
+
+    // Any thread, the memory has to stay valid for the process lifetime. False if it is too
+    // small or misaligned
+    bool attach(void *memory, size_t size);
+
+    bool isAttached() const {
+        return m_words.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Copies the factors if a write completed since the last call; false while nothing
+    // changed or Kotlin is in the middle of a write
+    bool poll(std::array<float, 3> &factors);
+
+    // Called right before the poller blocks. False if a write landed meanwhile, the poller
+    // must not block then or the write would go unnoticed until the next event
+    bool enterIdle();
+
+    void leaveIdle();
+
+    // completed writes seen so far
+    uint32_t getWriteCount() const {
+        return m_readSequence / 2u;
+    }
+
+private:
+    std::atomic<uint32_t> &word(Word index) const {
+        return m_words.load(std::memory_order_acquire)[index];
+    }
+
+    std::atomic<std::atomic<uint32_t> *> m_words{nullptr};
+    uint32_t m_readSequence = 0u;
+};
+
+#endif //ANDROIDVULKAN_PARAMBLOCK_H
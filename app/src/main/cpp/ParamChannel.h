@@ -0,0 +1,79 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PARAMCHANNEL_H
+#define ANDROIDVULKAN_PARAMCHANNEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ * ParamChannel hands a small parameter block from one producer thread to one consumer
+ * thread without locks, as a triple buffer: the producer writes its back slot and swaps
+ * it with the middle one, the consumer swaps the middle slot with its front slot when it
+ * was refreshed. Neither side ever waits for the other and the consumer always sees a
+ * complete block, the latest one published. Every publish bumps a version, so the consumer
+ * can tell whether anything arrived since its last snapshot.
+ */
+template<typename T>
+class ParamChannel {
+    static_assert(std::is_trivially_copyable<T>::value, "slots are copied by value");
+
+    static constexpr uint32_t INDEX_MASK = 3u;
+    static constexpr uint32_t FRESH_BIT = 4u; // middle slot holds an unread block
+
+    struct Slot {
+        T value;
+        uint64_t version;
+    };
+
+public:
+    explicit ParamChannel(const T &initial = T{}) {
+        for (Slot &slot: m_slots) {
+            slot = {initial, 0u};
+        }
+    }
+
+    // producer thread only
+    void publish(const T &value) {
+        m_slots[m_back] = {value, ++m_publishedVersion};
+        m_back = m_middle.exchange(m_back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // consumer thread only, cheap enough to call from a wait condition
+    bool hasUpdate() const {
+        return (m_middle.load(std::memory_order_acquire) & FRESH_BIT) != 0u;
+    }
+
+    // Consumer thread only. Copies the latest block into value, true if it was published
+    // after the previous snapshot
+    bool snapshot(T &value) {
+        if (hasUpdate()) {
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        const Slot &slot = m_slots[m_front];
+        value = slot.value;
+        const bool changed = slot.version != m_readVersion;
+        m_readVersion = slot.version;
+        return changed;
+    }
+
+    // version of the block the last snapshot returned
+    uint64_t getReadVersion() const {
+        return m_readVersion;
+    }
+
+private:
+    Slot m_slots[3];
+    // slot indices: back and front are owned by one side each, middle is exchanged;
+    // the sides are kept on separate cache lines
+    uint32_t m_back = 0u;
+    uint64_t m_publishedVersion = 0u;
+    alignas(64) std::atomic<uint32_t> m_middle{1u};
+    alignas(64) uint32_t m_front = 2u;
+    uint64_t m_readVersion = 0u;
+};
+
+#endif //ANDROIDVULKAN_PARAMCHANNEL_H
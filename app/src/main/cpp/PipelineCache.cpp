@@ -0,0 +1,187 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "PipelineCache.h"
+#include "Utils.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+PipelineCache::~PipelineCache() {
+    destroy();
+}
+
+void PipelineCache::init(VkDevice device, const VkPhysicalDeviceProperties &props,
+                         std::string path) {
+    assert(device);
+    destroy();
+
+    m_device = device;
+    m_props = props;
+    m_path = std::move(path);
+
+    const Platform::AssetView initialData = loadValidated();
+    m_warm = !initialData.empty();
+    m_savedHash = hash(initialData.data(), initialData.size());
+    m_savedSize = initialData.size();
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    VK_CHECK(vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache));
+
+    LOGI("Pipeline cache %s (%zu bytes)", m_warm ? "loaded" : "is cold", initialData.size());
+
+    if (!m_path.empty()) {
+        m_stop = false;
+        m_writer = std::thread(&PipelineCache::runWriter, this);
+    }
+}
+
+void PipelineCache::destroy() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        m_writer.join();
+    }
+    m_pending.clear();
+    m_hasPending = false;
+    if (m_cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+    }
+    m_warm = false;
+    m_savedHash = 0u;
+    m_savedSize = 0u;
+}
+
+Platform::AssetView PipelineCache::loadValidated() const {
+    if (m_path.empty()) {
+        return {};
+    }
+    const Platform::AssetView file = Platform::mapFile(m_path.c_str());
+    if (!file.data()) {
+        return {};
+    }
+
+    FileHeader header{};
+    if (file.size() < sizeof(header)) {
+        LOGE("Pipeline cache %s is truncated", m_path.c_str());
+        return {};
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    const FileHeader expected = makeHeader(nullptr, 0u);
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.vendorID != expected.vendorID || header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        LOGI("Pipeline cache %s belongs to another device or driver, ignoring it",
+             m_path.c_str());
+        return {};
+    }
+
+    if (header.dataSize > MAX_DATA_SIZE) {
+        LOGE("Pipeline cache %s is corrupted, ignoring it", m_path.c_str());
+        return {};
+    }
+    const Platform::AssetView data = file.subView(sizeof(header), file.size() - sizeof(header));
+    if (data.size() < header.dataSize || hash(data.data(), header.dataSize) != header.dataHash) {
+        LOGE("Pipeline cache %s is corrupted, ignoring it", m_path.c_str());
+        return {};
+    }
+    // still mapped, nothing is copied before the driver parses it
+    return data.subView(0u, static_cast<size_t>(header.dataSize));
+}
+
+PipelineCache::FileHeader PipelineCache::makeHeader(const uint8_t *data, size_t size) const {
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.vendorID = m_props.vendorID;
+    header.deviceID = m_props.deviceID;
+    header.driverVersion = m_props.driverVersion;
+    memcpy(header.pipelineCacheUUID, m_props.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = size;
+    header.dataHash = hash(data, size);
+    return header;
+}
+
+uint64_t PipelineCache::hash(const uint8_t *data, size_t size) {
+    // FNV-1a, only meant to catch torn or truncated writes
+    uint64_t value = 0xcbf29ce484222325ull;
+    for (size_t i = 0u; i < size; ++i) {
+        value = (value ^ data[i]) * 0x100000001b3ull;
+    }
+    return value;
+}
+
+void PipelineCache::saveAsync() {
+    if (m_path.empty() || m_cache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t size = 0u;
+    VK_CHECK(vkGetPipelineCacheData(m_device, m_cache, &size, nullptr));
+    std::vector<uint8_t> data(size);
+    VK_CHECK(vkGetPipelineCacheData(m_device, m_cache, &size, data.data()));
+    data.resize(size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = std::move(data);
+        m_hasPending = true;
+    }
+    m_cv.notify_one();
+}
+
+void PipelineCache::runWriter() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        // a snapshot taken before destroy is still written
+        m_cv.wait(lock, [this]() { return m_stop || m_hasPending; });
+        if (!m_hasPending) {
+            break;
+        }
+        std::vector<uint8_t> data = std::move(m_pending);
+        m_hasPending = false;
+        lock.unlock();
+
+        // hashing and file I/O stay off the render thread; equal size is no proof of
+        // equal contents, the hash decides
+        const FileHeader header = makeHeader(data.data(), data.size());
+        if (header.dataSize != m_savedSize || header.dataHash != m_savedHash) {
+            if (writeFile(m_path, header, data)) {
+                m_savedHash = header.dataHash;
+                m_savedSize = data.size();
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+bool PipelineCache::writeFile(const std::string &path, const FileHeader &header,
+                              const std::vector<uint8_t> &data) {
+    // a crash mid-write must not leave a half written cache behind
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+            !file.write(reinterpret_cast<const char *>(data.data()), data.size())) {
+            LOGE("Failed to write pipeline cache %s", tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGE("Failed to replace pipeline cache %s", path.c_str());
+        return false;
+    }
+    LOGD("Pipeline cache saved (%zu bytes)", data.size());
+    return true;
+}
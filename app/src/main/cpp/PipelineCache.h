@@ -0,0 +1,91 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PIPELINECACHE_H
+#define ANDROIDVULKAN_PIPELINECACHE_H
+
+#include "Platform.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/*
+ * PipelineCache wraps a VkPipelineCache persisted between runs. The blob is stored
+ * behind our own header and is only handed to the driver when vendor, device, driver
+ * version and pipelineCacheUUID match, since some drivers misbehave on foreign data.
+ * Saving happens on a writer thread through a temp file + rename; snapshots taken while a
+ * write is in flight replace each other, only the latest one is written afterwards.
+ */
+class PipelineCache {
+    static constexpr uint32_t MAGIC = 0x43504B56u; // "VKPC"
+    static constexpr uint32_t VERSION = 1u;
+    static constexpr uint64_t MAX_DATA_SIZE = 64ull * 1024ull * 1024ull;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+public:
+    ~PipelineCache();
+
+    // empty path keeps the cache in memory only
+    void init(VkDevice device, const VkPhysicalDeviceProperties &props, std::string path);
+
+    // finishes a pending save
+    void destroy();
+
+    // Snapshots the cache for the writer, which skips it if the contents match what was
+    // loaded or last saved. Never waits for a write
+    void saveAsync();
+
+    VkPipelineCache get() const {
+        return m_cache;
+    }
+
+    // true if the cache was populated from disk
+    bool isWarm() const {
+        return m_warm;
+    }
+
+private:
+    // the blob past our header, still mapped from the file
+    Platform::AssetView loadValidated() const;
+
+    FileHeader makeHeader(const uint8_t *data, size_t size) const;
+
+    static uint64_t hash(const uint8_t *data, size_t size);
+
+    static bool writeFile(const std::string &path, const FileHeader &header,
+                          const std::vector<uint8_t> &data);
+
+    void runWriter();
+
+    VkDevice m_device = nullptr;
+    VkPhysicalDeviceProperties m_props{};
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    std::string m_path;
+    bool m_warm = false;
+    uint64_t m_savedHash = 0u; // of the blob on disk, writer thread only once it runs
+    size_t m_savedSize = 0u;
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<uint8_t> m_pending; // latest snapshot not written yet
+    bool m_hasPending = false;
+    bool m_stop = false;
+};
+
+#endif //ANDROIDVULKAN_PIPELINECACHE_H
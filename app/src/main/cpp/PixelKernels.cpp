@@ -0,0 +1,353 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "PixelKernels.h"
+
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define PIXEL_KERNELS_NEON 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define PIXEL_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace PixelKernels {
+
+    namespace {
+
+        using RowFn = void (*)(const uint8_t *src, uint8_t *dst, uint32_t width);
+
+        struct RowKernels {
+            Isa isa;
+            RowFn rgbToRgba;
+            RowFn swizzleBgra;
+            RowFn premultiplyAlpha;
+        };
+
+        // exact round(c * a / 255)
+        inline uint8_t mulDiv255(uint32_t c, uint32_t a) {
+            const uint32_t t = c * a + 128u;
+            return static_cast<uint8_t>((t + (t >> 8u)) >> 8u);
+        }
+
+        void rgbToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            for (uint32_t x = 0u; x < width; ++x, src += 3, dst += 4) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 255u;
+            }
+        }
+
+        void swizzleBgraScalar(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            for (uint32_t x = 0u; x < width; ++x, src += 4, dst += 4) {
+                const uint8_t r = src[0];
+                dst[0] = src[2];
+                dst[1] = src[1];
+                dst[2] = r;
+                dst[3] = src[3];
+            }
+        }
+
+        void premultiplyAlphaScalar(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            for (uint32_t x = 0u; x < width; ++x, src += 4, dst += 4) {
+                const uint8_t a = src[3];
+                dst[0] = mulDiv255(src[0], a);
+                dst[1] = mulDiv255(src[1], a);
+                dst[2] = mulDiv255(src[2], a);
+                dst[3] = a;
+            }
+        }
+
+        constexpr RowKernels SCALAR_KERNELS = {Isa::Scalar, rgbToRgbaScalar, swizzleBgraScalar,
+                                               premultiplyAlphaScalar};
+
+#if PIXEL_KERNELS_NEON
+        void rgbToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            uint32_t x = 0u;
+            for (; x + 16u <= width; x += 16u) {
+                const uint8x16x3_t rgb = vld3q_u8(src + x * 3u);
+                uint8x16x4_t rgba;
+                rgba.val[0] = rgb.val[0];
+                rgba.val[1] = rgb.val[1];
+                rgba.val[2] = rgb.val[2];
+                rgba.val[3] = vdupq_n_u8(255u);
+                vst4q_u8(dst + x * 4u, rgba);
+            }
+            rgbToRgbaScalar(src + x * 3u, dst + x * 4u, width - x);
+        }
+
+        void swizzleBgraNeon(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            uint32_t x = 0u;
+            for (; x + 16u <= width; x += 16u) {
+                uint8x16x4_t px = vld4q_u8(src + x * 4u);
+                const uint8x16_t r = px.val[0];
+                px.val[0] = px.val[2];
+                px.val[2] = r;
+                vst4q_u8(dst + x * 4u, px);
+            }
+            swizzleBgraScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        // (t + ((t + 128) >> 8) + 128) >> 8, the same rounding as mulDiv255
+        inline uint8x16_t mulDiv255Neon(uint8x16_t c, uint8x16_t a) {
+            const uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+            const uint16x8_t hi = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+            return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)),
+                               vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+        }
+
+        void premultiplyAlphaNeon(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            uint32_t x = 0u;
+            for (; x + 16u <= width; x += 16u) {
+                uint8x16x4_t px = vld4q_u8(src + x * 4u);
+                px.val[0] = mulDiv255Neon(px.val[0], px.val[3]);
+                px.val[1] = mulDiv255Neon(px.val[1], px.val[3]);
+                px.val[2] = mulDiv255Neon(px.val[2], px.val[3]);
+                vst4q_u8(dst + x * 4u, px);
+            }
+            premultiplyAlphaScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        constexpr RowKernels NEON_KERNELS = {Isa::Neon, rgbToRgbaNeon, swizzleBgraNeon,
+                                             premultiplyAlphaNeon};
+#endif
+
+#if PIXEL_KERNELS_X86
+        __attribute__((target("ssse3")))
+        void rgbToRgbaSsse3(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1,
+                                                  9, 10, 11, -1);
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            uint32_t x = 0u;
+            // 16 bytes are read for 4 pixels, stop early enough to stay inside the row
+            for (; x + 6u <= width; x += 4u) {
+                const __m128i rgb = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 3u));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4u),
+                                 _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+            }
+            rgbToRgbaScalar(src + x * 3u, dst + x * 4u, width - x);
+        }
+
+        __attribute__((target("ssse3")))
+        void swizzleBgraSsse3(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11,
+                                                  14, 13, 12, 15);
+            uint32_t x = 0u;
+            for (; x + 4u <= width; x += 4u) {
+                const __m128i px = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 4u));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4u),
+                                 _mm_shuffle_epi8(px, shuffle));
+            }
+            swizzleBgraScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        // 8 channels widened to 16 bit, alpha lanes are passed through
+        __attribute__((target("ssse3")))
+        inline __m128i premultiplySsse3(__m128i c, __m128i alphaLanes) {
+            const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xFF), 0xFF);
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+            t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+            return _mm_or_si128(_mm_andnot_si128(alphaLanes, t), _mm_and_si128(alphaLanes, c));
+        }
+
+        __attribute__((target("ssse3")))
+        void premultiplyAlphaSsse3(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            uint32_t x = 0u;
+            for (; x + 4u <= width; x += 4u) {
+                const __m128i px = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 4u));
+                const __m128i lo = premultiplySsse3(_mm_unpacklo_epi8(px, zero), alphaLanes);
+                const __m128i hi = premultiplySsse3(_mm_unpackhi_epi8(px, zero), alphaLanes);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4u),
+                                 _mm_packus_epi16(lo, hi));
+            }
+            premultiplyAlphaScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        __attribute__((target("avx2")))
+        void rgbToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1,
+                                                     9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1,
+                                                     6, 7, 8, -1, 9, 10, 11, -1);
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            uint32_t x = 0u;
+            // each lane gets 4 pixels from its own 16 byte load
+            for (; x + 10u <= width; x += 8u) {
+                const __m128i lo = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 3u));
+                const __m128i hi = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i *>(src + x * 3u + 12u));
+                const __m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4u),
+                                    _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alpha));
+            }
+            rgbToRgbaScalar(src + x * 3u, dst + x * 4u, width - x);
+        }
+
+        __attribute__((target("avx2")))
+        void swizzleBgraAvx2(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11,
+                                                     14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4, 7,
+                                                     10, 9, 8, 11, 14, 13, 12, 15);
+            uint32_t x = 0u;
+            for (; x + 8u <= width; x += 8u) {
+                const __m256i px = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(src + x * 4u));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4u),
+                                    _mm256_shuffle_epi8(px, shuffle));
+            }
+            swizzleBgraScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i premultiplyAvx2(__m256i c, __m256i alphaLanes) {
+            const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, 0xFF), 0xFF);
+            __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(c, a), _mm256_set1_epi16(128));
+            t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+            return _mm256_blendv_epi8(t, c, alphaLanes);
+        }
+
+        __attribute__((target("avx2")))
+        void premultiplyAlphaAvx2(const uint8_t *src, uint8_t *dst, uint32_t width) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0,
+                                                        -1, 0, 0, 0, -1, 0, 0, 0);
+            uint32_t x = 0u;
+            // unpack and pack both work per 128 bit lane, so pixel order is preserved
+            for (; x + 8u <= width; x += 8u) {
+                const __m256i px = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i *>(src + x * 4u));
+                const __m256i lo = premultiplyAvx2(_mm256_unpacklo_epi8(px, zero), alphaLanes);
+                const __m256i hi = premultiplyAvx2(_mm256_unpackhi_epi8(px, zero), alphaLanes);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4u),
+                                    _mm256_packus_epi16(lo, hi));
+            }
+            premultiplyAlphaScalar(src + x * 4u, dst + x * 4u, width - x);
+        }
+
+        constexpr RowKernels SSSE3_KERNELS = {Isa::Ssse3, rgbToRgbaSsse3, swizzleBgraSsse3,
+                                              premultiplyAlphaSsse3};
+        constexpr RowKernels AVX2_KERNELS = {Isa::Avx2, rgbToRgbaAvx2, swizzleBgraAvx2,
+                                             premultiplyAlphaAvx2};
+#endif
+
+        const RowKernels *getKernels(Isa isa) {
+            switch (isa) {
+#if PIXEL_KERNELS_NEON
+                case Isa::Neon:
+                    return &NEON_KERNELS;
+#endif
+#if PIXEL_KERNELS_X86
+                case Isa::Ssse3:
+                    return &SSSE3_KERNELS;
+                case Isa::Avx2:
+                    return &AVX2_KERNELS;
+#endif
+                default:
+                    return &SCALAR_KERNELS;
+            }
+        }
+
+        const RowKernels *g_kernels = getKernels(getBestIsa());
+
+        void forEachRow(RowFn fn, const uint8_t *src, size_t srcPitch, uint8_t *dst,
+                        size_t dstPitch, uint32_t width, uint32_t height) {
+            for (uint32_t y = 0u; y < height; ++y, src += srcPitch, dst += dstPitch) {
+                fn(src, dst, width);
+            }
+        }
+
+    }  // namespace
+
+    bool isSupported(Isa isa) {
+        switch (isa) {
+            case Isa::Scalar:
+                return true;
+#if PIXEL_KERNELS_NEON
+            case Isa::Neon:
+                return true;
+#endif
+#if PIXEL_KERNELS_X86
+            case Isa::Ssse3:
+                return __builtin_cpu_supports("ssse3");
+            case Isa::Avx2:
+                return __builtin_cpu_supports("avx2");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    Isa getBestIsa() {
+#if PIXEL_KERNELS_NEON_DEFAULT
+        constexpr Isa NEON_DEFAULT = Isa::Neon;
+#else
+        // not yet verified bit exact against scalar on arm64, see pixel_kernels_bench --check
+        constexpr Isa NEON_DEFAULT = Isa::Scalar;
+#endif
+        for (Isa isa: {Isa::Avx2, Isa::Ssse3, NEON_DEFAULT}) {
+            if (isSupported(isa)) {
+                return isa;
+            }
+        }
+        return Isa::Scalar;
+    }
+
+    const char *getIsaName(Isa isa) {
+        switch (isa) {
+            case Isa::Neon:
+                return "NEON";
+            case Isa::Ssse3:
+                return "SSSE3";
+            case Isa::Avx2:
+                return "AVX2";
+            default:
+                return "scalar";
+        }
+    }
+
+    void setIsa(Isa isa) {
+        g_kernels = getKernels(isSupported(isa) ? isa : Isa::Scalar);
+    }
+
+    Isa getIsa() {
+        return g_kernels->isa;
+    }
+
+    void copyRows(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                  size_t rowBytes, uint32_t rows) {
+        // memcpy already is the widest copy the libc has for this CPU
+        if (srcPitch == rowBytes && dstPitch == rowBytes) {
+            memcpy(dst, src, rowBytes * rows);
+            return;
+        }
+        for (uint32_t y = 0u; y < rows; ++y, src += srcPitch, dst += dstPitch) {
+            memcpy(dst, src, rowBytes);
+        }
+    }
+
+    void rgbToRgba(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                   uint32_t width, uint32_t height) {
+        forEachRow(g_kernels->rgbToRgba, src, srcPitch, dst, dstPitch, width, height);
+    }
+
+    void swizzleBgra(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                     uint32_t width, uint32_t height) {
+        forEachRow(g_kernels->swizzleBgra, src, srcPitch, dst, dstPitch, width, height);
+    }
+
+    void premultiplyAlpha(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                          uint32_t width, uint32_t height) {
+        forEachRow(g_kernels->premultiplyAlpha, src, srcPitch, dst, dstPitch, width, height);
+    }
+
+}  // namespace PixelKernels
@@ -0,0 +1,56 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PIXELKERNELS_H
+#define ANDROIDVULKAN_PIXELKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Row based pixel conversion kernels used when filling staging memory. Every kernel takes
+ * separate source and destination pitches in bytes, so rows can be written straight into
+ * a buffer laid out by vkGetImageSubresourceLayout. SSSE3/AVX2 are used on x86 when the
+ * CPU reports it and a scalar loop everywhere else. The NEON kernels are only picked by
+ * default in builds with PIXEL_KERNELS_NEON_DEFAULT, otherwise setIsa has to ask for them.
+ */
+namespace PixelKernels {
+
+    enum class Isa {
+        Scalar,
+        Neon,
+        Ssse3,
+        Avx2
+    };
+
+    // best implementation the running CPU supports and the build allows as default
+    Isa getBestIsa();
+
+    bool isSupported(Isa isa);
+
+    const char *getIsaName(Isa isa);
+
+    // switches every kernel to the given implementation, meant for benchmarks and tests
+    void setIsa(Isa isa);
+
+    Isa getIsa();
+
+    void copyRows(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                  size_t rowBytes, uint32_t rows);
+
+    // RGB8 -> RGBA8 with opaque alpha
+    void rgbToRgba(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                   uint32_t width, uint32_t height);
+
+    // RGBA8 <-> BGRA8, src may equal dst
+    void swizzleBgra(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                     uint32_t width, uint32_t height);
+
+    // RGBA8 color channels multiplied by alpha, rounded exactly; src may equal dst
+    void premultiplyAlpha(const uint8_t *src, size_t srcPitch, uint8_t *dst, size_t dstPitch,
+                          uint32_t width, uint32_t height);
+
+}  // namespace PixelKernels
+
+#endif //ANDROIDVULKAN_PIXELKERNELS_H
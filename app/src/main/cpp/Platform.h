@@ -0,0 +1,97 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PLATFORM_H
+#define ANDROIDVULKAN_PLATFORM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#define LOG_TAG "my_engine"
+#define LOGI(...) Platform::logPrint(Platform::LogLevel::Info, __VA_ARGS__)
+#define LOGD(...) Platform::logPrint(Platform::LogLevel::Debug, __VA_ARGS__)
+#define LOGE(...) Platform::logPrint(Platform::LogLevel::Error, __VA_ARGS__)
+
+/*
+ * Everything the engine needs from the operating system goes through this layer:
+ * PlatformAndroid implements it over AAssetManager/ANativeWindow/logcat,
+ * PlatformLinux over the file system/stderr for the desktop host build.
+ */
+namespace Platform {
+
+    enum class LogLevel {
+        Debug,
+        Info,
+        Error
+    };
+
+    void logPrint(LogLevel level, const char *fmt, ...);
+
+    /*
+     * Read-only bytes of a file or asset. Copies share the backing storage, a mapping
+     * where the platform allows it, which is released with the last copy. Pages are only
+     * read from storage once touched.
+     */
+    class AssetView {
+    public:
+        AssetView() = default;
+
+        AssetView(std::shared_ptr<const void> owner, const uint8_t *data, size_t size)
+                : m_owner(std::move(owner)), m_data(data), m_size(size) {
+        }
+
+        const uint8_t *data() const {
+            return m_data;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return m_size == 0u;
+        }
+
+        // shares the backing storage, the range has to lie within this view
+        AssetView subView(size_t offset, size_t size) const {
+            return {m_owner, m_data + offset, size};
+        }
+
+    private:
+        std::shared_ptr<const void> m_owner;
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0u;
+    };
+
+    // maps a regular file, data() is null if it cannot be opened
+    AssetView mapFile(const char *path);
+
+    class AssetSource {
+    public:
+        virtual ~AssetSource() = default;
+
+        // maps the asset without copying it, aborts if it does not exist
+        virtual AssetView map(const char *path) const = 0;
+
+        // lets callers probe optional variants of an asset without aborting
+        virtual bool exists(const char *path) const = 0;
+    };
+
+    class SurfaceProvider {
+    public:
+        virtual ~SurfaceProvider() = default;
+
+        // platform specific instance extension required besides VK_KHR_surface
+        virtual const char *getInstanceExtension() const = 0;
+
+        virtual VkSurfaceKHR createSurface(VkInstance instance) = 0;
+    };
+
+}  // namespace Platform
+
+#endif //ANDROIDVULKAN_PLATFORM_H
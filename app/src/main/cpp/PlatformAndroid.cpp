@@ -0,0 +1,107 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifdef __ANDROID__
+
+#include "PlatformAndroid.h"
+#include "PlatformPosix.h"
+#include "Utils.h"
+
+#include <android/log.h>
+#include <cassert>
+#include <cstdarg>
+#include <unistd.h>
+#include <vulkan/vulkan_android.h>
+
+namespace Platform {
+    void logPrint(LogLevel level, const char *fmt, ...) {
+        int priority = ANDROID_LOG_INFO;
+        switch (level) {
+            case LogLevel::Debug:
+                priority = ANDROID_LOG_DEBUG;
+                break;
+            case LogLevel::Error:
+                priority = ANDROID_LOG_ERROR;
+                break;
+            default:
+                break;
+        }
+
+        va_list args;
+        va_start(args, fmt);
+        __android_log_vprint(priority, LOG_TAG, fmt, args);
+        va_end(args);
+    }
+
+    AndroidAssetSource::AndroidAssetSource(AAssetManager *assetManager)
+            : m_assetManager(assetManager) {
+        assert(m_assetManager);
+    }
+
+    AssetView AndroidAssetSource::map(const char *path) const {
+        AAsset *file = AAssetManager_open(m_assetManager, path, AASSET_MODE_BUFFER);
+        if (!file) {
+            LOGE("Asset %s not found", path);
+            abort();
+        }
+        const size_t length = static_cast<size_t>(AAsset_getLength64(file));
+
+        // stored (uncompressed) entries are mapped straight out of the APK
+        off64_t start = 0;
+        off64_t fdLength = 0;
+        const int fd = AAsset_openFileDescriptor64(file, &start, &fdLength);
+        if (fd >= 0) {
+            AssetView view = mapRange(fd, static_cast<off_t>(start), length);
+            close(fd);
+            if (view.data()) {
+                AAsset_close(file);
+                return view;
+            }
+        }
+
+        // deflated entries are inflated once by the asset manager and kept with the asset
+        const void *buffer = AAsset_getBuffer(file);
+        if (!buffer) {
+            LOGE("Failed to read asset %s", path);
+            abort();
+        }
+        std::shared_ptr<const void> owner(file, [](const void *asset) {
+            AAsset_close(static_cast<AAsset *>(const_cast<void *>(asset)));
+        });
+        return {std::move(owner), static_cast<const uint8_t *>(buffer), length};
+    }
+
+    bool AndroidAssetSource::exists(const char *path) const {
+        AAsset *file = AAssetManager_open(m_assetManager, path, AASSET_MODE_UNKNOWN);
+        if (!file) {
+            return false;
+        }
+        AAsset_close(file);
+        return true;
+    }
+
+    AndroidSurfaceProvider::AndroidSurfaceProvider(ANativeWindow *window)
+            : m_winController(window) {
+        assert(m_winController);
+    }
+
+    const char *AndroidSurfaceProvider::getInstanceExtension() const {
+        return VK_KHR_ANDROID_SURFACE_EXTENSION_NAME;
+    }
+
+    VkSurfaceKHR AndroidSurfaceProvider::createSurface(VkInstance instance) {
+        const VkAndroidSurfaceCreateInfoKHR create_info{
+                .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
+                .pNext = nullptr,
+                .flags = 0,
+                .window = m_winController.get()};
+
+        VkSurfaceKHR surface;
+        VK_CHECK(vkCreateAndroidSurfaceKHR(instance, &create_info,
+                                           nullptr, &surface));
+        return surface;
+    }
+}  // namespace Platform
+
+#endif // __ANDROID__
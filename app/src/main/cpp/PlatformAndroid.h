@@ -0,0 +1,49 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PLATFORMANDROID_H
+#define ANDROIDVULKAN_PLATFORMANDROID_H
+
+#ifdef __ANDROID__
+
+#include "Platform.h"
+#include <android/asset_manager.h>
+#include <android/native_window.h>
+#include <memory>
+
+namespace Platform {
+
+    class AndroidAssetSource : public AssetSource {
+    public:
+        explicit AndroidAssetSource(AAssetManager *assetManager);
+
+        AssetView map(const char *path) const override;
+
+        bool exists(const char *path) const override;
+
+    private:
+        AAssetManager *m_assetManager = nullptr;
+    };
+
+    class AndroidSurfaceProvider : public SurfaceProvider {
+        struct ANativeWindowDeleter {
+            void operator()(ANativeWindow *window) { ANativeWindow_release(window); }
+        };
+
+    public:
+        explicit AndroidSurfaceProvider(ANativeWindow *window);
+
+        const char *getInstanceExtension() const override;
+
+        VkSurfaceKHR createSurface(VkInstance instance) override;
+
+    private:
+        std::unique_ptr<ANativeWindow, ANativeWindowDeleter> m_winController = nullptr;
+    };
+
+}  // namespace Platform
+
+#endif // __ANDROID__
+
+#endif //ANDROIDVULKAN_PLATFORMANDROID_H
@@ -0,0 +1,60 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef __ANDROID__
+
+#include "PlatformLinux.h"
+#include "PlatformPosix.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace Platform {
+    void logPrint(LogLevel level, const char *fmt, ...) {
+        const char *prefix = "I";
+        switch (level) {
+            case LogLevel::Debug:
+                prefix = "D";
+                break;
+            case LogLevel::Error:
+                prefix = "E";
+                break;
+            default:
+                break;
+        }
+
+        fprintf(stderr, "%s/%s: ", prefix, LOG_TAG);
+        va_list args;
+        va_start(args, fmt);
+        vfprintf(stderr, fmt, args);
+        va_end(args);
+
+        // logcat terminates every message, stderr does not
+        const size_t length = strlen(fmt);
+        if (length == 0 || fmt[length - 1] != '\n') {
+            fputc('\n', stderr);
+        }
+    }
+
+    FileAssetSource::FileAssetSource(std::string rootDir) : m_rootDir(std::move(rootDir)) {
+    }
+
+    AssetView FileAssetSource::map(const char *path) const {
+        const std::string fullPath = m_rootDir + "/" + path;
+        AssetView view = mapFile(fullPath.c_str());
+        if (!view.data()) {
+            LOGE("Asset %s not found", fullPath.c_str());
+            abort();
+        }
+        return view;
+    }
+
+    bool FileAssetSource::exists(const char *path) const {
+        return static_cast<bool>(std::ifstream(m_rootDir + "/" + path, std::ios::binary));
+    }
+}  // namespace Platform
+
+#endif // __ANDROID__
@@ -0,0 +1,32 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PLATFORMLINUX_H
+#define ANDROIDVULKAN_PLATFORMLINUX_H
+
+#ifndef __ANDROID__
+
+#include "Platform.h"
+#include <string>
+
+namespace Platform {
+
+    // Resolves asset paths relative to a root directory laid out like app/src/main/assets
+    class FileAssetSource : public AssetSource {
+    public:
+        explicit FileAssetSource(std::string rootDir);
+
+        AssetView map(const char *path) const override;
+
+        bool exists(const char *path) const override;
+
+    private:
+        std::string m_rootDir;
+    };
+
+}  // namespace Platform
+
+#endif // __ANDROID__
+
+#endif //ANDROIDVULKAN_PLATFORMLINUX_H
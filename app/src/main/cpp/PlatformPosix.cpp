@@ -0,0 +1,49 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "PlatformPosix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Platform {
+    AssetView mapRange(int fd, off_t offset, size_t size) {
+        if (size == 0u) {
+            // mmap rejects empty ranges, a non-null pointer keeps callers simple
+            static const uint8_t empty = 0u;
+            return {nullptr, &empty, 0u};
+        }
+
+        // mmap offsets have to be page aligned, assets inside an APK usually are not
+        static const off_t pageSize = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+        const off_t mapOffset = offset / pageSize * pageSize;
+        const size_t mapSize = size + static_cast<size_t>(offset - mapOffset);
+        void *base = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, mapOffset);
+        if (base == MAP_FAILED) {
+            return {};
+        }
+
+        std::shared_ptr<const void> owner(base, [mapSize](const void *ptr) {
+            munmap(const_cast<void *>(ptr), mapSize);
+        });
+        return {std::move(owner), static_cast<const uint8_t *>(base) + (offset - mapOffset),
+                size};
+    }
+
+    AssetView mapFile(const char *path) {
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return {};
+        }
+        struct stat info{};
+        AssetView view;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            view = mapRange(fd, 0, static_cast<size_t>(info.st_size));
+        }
+        close(fd);
+        return view;
+    }
+}  // namespace Platform
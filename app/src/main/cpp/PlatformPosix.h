@@ -0,0 +1,22 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PLATFORMPOSIX_H
+#define ANDROIDVULKAN_PLATFORMPOSIX_H
+
+#include "Platform.h"
+#include <sys/types.h>
+
+/*
+ * mmap helpers shared by the Android and Linux platform layers, both are POSIX.
+ */
+namespace Platform {
+
+    // maps size bytes of fd starting at any offset, the descriptor can be closed afterwards;
+    // data() is null on failure
+    AssetView mapRange(int fd, off_t offset, size_t size);
+
+}  // namespace Platform
+
+#endif //ANDROIDVULKAN_PLATFORMPOSIX_H
@@ -0,0 +1,623 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "PngDecoder.h"
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace Png {
+
+    namespace {
+
+        constexpr std::array<uint8_t, 8> SIGNATURE = {137u, 80u, 78u, 71u, 13u, 10u, 26u, 10u};
+        constexpr uint32_t MAX_DIMENSION = 1u << 24u;
+
+        constexpr uint8_t COLOR_GRAY = 0u;
+        constexpr uint8_t COLOR_RGB = 2u;
+        constexpr uint8_t COLOR_PALETTE = 3u;
+        constexpr uint8_t COLOR_GRAY_ALPHA = 4u;
+        constexpr uint8_t COLOR_RGBA = 6u;
+
+        // deflate limits, RFC 1951
+        constexpr size_t WINDOW_SIZE = 32768u;
+        constexpr size_t MAX_MATCH = 258u;
+        constexpr uint32_t MAX_CODE_BITS = 15u;
+        constexpr uint32_t FAST_BITS = 10u;
+
+        constexpr uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                              31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195,
+                                              227, 258};
+        constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3,
+                                              3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        constexpr uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                            193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                            4097, 6145, 8193, 12289, 16385, 24577};
+        constexpr uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                            8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        constexpr uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12,
+                                                   3, 13, 2, 14, 1, 15};
+
+        uint32_t readBE32(const uint8_t *p) {
+            return (uint32_t(p[0]) << 24u) | (uint32_t(p[1]) << 16u) | (uint32_t(p[2]) << 8u) |
+                   uint32_t(p[3]);
+        }
+
+        struct Span {
+            const uint8_t *data;
+            size_t size;
+        };
+
+        // LSB first bit reader over the IDAT payloads, which form one zlib stream
+        class BitReader {
+        public:
+            explicit BitReader(const std::vector<Span> &spans) : m_spans(spans) {
+            }
+
+            // makes at least 57 bits available, zeros are fed past the end
+            void refill() {
+                while (m_count <= 56u) {
+                    m_bits |= static_cast<uint64_t>(nextByte()) << m_count;
+                    m_count += 8u;
+                }
+            }
+
+            uint32_t peek(uint32_t n) const {
+                return static_cast<uint32_t>(m_bits & ((uint64_t(1) << n) - 1u));
+            }
+
+            void consume(uint32_t n) {
+                m_bits >>= n;
+                m_count -= n;
+            }
+
+            uint32_t read(uint32_t n) {
+                if (m_count < n) {
+                    refill();
+                }
+                const uint32_t value = peek(n);
+                consume(n);
+                return value;
+            }
+
+            uint64_t bits() const {
+                return m_bits;
+            }
+
+            void alignToByte() {
+                consume(m_count & 7u);
+            }
+
+            // true once bits past the end of the stream were consumed
+            bool overrun() const {
+                return m_padding * 8u > m_count;
+            }
+
+        private:
+            uint8_t nextByte() {
+                while (m_span < m_spans.size()) {
+                    if (m_offset < m_spans[m_span].size) {
+                        return m_spans[m_span].data[m_offset++];
+                    }
+                    ++m_span;
+                    m_offset = 0u;
+                }
+                ++m_padding;
+                return 0u;
+            }
+
+            const std::vector<Span> &m_spans;
+            size_t m_span = 0u;
+            size_t m_offset = 0u;
+            size_t m_padding = 0u;
+            uint64_t m_bits = 0u;
+            uint32_t m_count = 0u;
+        };
+
+        // canonical Huffman code with a lookup table for codes up to FAST_BITS long
+        struct Huffman {
+            uint16_t fast[1u << FAST_BITS]; // symbol << 4 | length, 0 for longer codes
+            uint16_t count[MAX_CODE_BITS + 1u];
+            uint16_t symbols[288];
+
+            bool build(const uint8_t *lengths, uint32_t n) {
+                memset(count, 0, sizeof(count));
+                memset(fast, 0, sizeof(fast));
+                for (uint32_t i = 0u; i < n; ++i) {
+                    ++count[lengths[i]];
+                }
+                count[0] = 0u;
+
+                int left = 1;
+                for (uint32_t len = 1u; len <= MAX_CODE_BITS; ++len) {
+                    left = (left << 1) - count[len];
+                    if (left < 0) {
+                        return false; // over-subscribed
+                    }
+                }
+
+                uint16_t offsets[MAX_CODE_BITS + 2u];
+                uint32_t nextCode[MAX_CODE_BITS + 1u];
+                offsets[1] = 0u;
+                nextCode[0] = 0u;
+                uint32_t code = 0u;
+                for (uint32_t len = 1u; len <= MAX_CODE_BITS; ++len) {
+                    offsets[len + 1u] = offsets[len] + count[len];
+                    code = (code + count[len - 1u]) << 1u;
+                    nextCode[len] = code;
+                }
+
+                for (uint32_t symbol = 0u; symbol < n; ++symbol) {
+                    const uint32_t len = lengths[symbol];
+                    if (len == 0u) {
+                        continue;
+                    }
+                    symbols[offsets[len]++] = static_cast<uint16_t>(symbol);
+                    if (len <= FAST_BITS) {
+                        // the stream holds codes MSB first, the table is indexed LSB first
+                        uint32_t reversed = 0u;
+                        for (uint32_t c = nextCode[len], i = 0u; i < len; ++i, c >>= 1u) {
+                            reversed = (reversed << 1u) | (c & 1u);
+                        }
+                        for (uint32_t k = reversed; k < (1u << FAST_BITS); k += 1u << len) {
+                            fast[k] = static_cast<uint16_t>((symbol << 4u) | len);
+                        }
+                    }
+                    ++nextCode[len];
+                }
+                return true;
+            }
+
+            // expects at least MAX_CODE_BITS bits in the reader, -1 for an invalid code
+            int decode(BitReader &reader) const {
+                const uint16_t entry = fast[reader.peek(FAST_BITS)];
+                if (entry) {
+                    reader.consume(entry & 15u);
+                    return entry >> 4u;
+                }
+                const uint64_t bits = reader.bits();
+                int code = 0;
+                int first = 0;
+                int index = 0;
+                for (uint32_t len = 1u; len <= MAX_CODE_BITS; ++len) {
+                    code |= static_cast<int>((bits >> (len - 1u)) & 1u);
+                    const int n = count[len];
+                    if (code - n < first) {
+                        reader.consume(len);
+                        return symbols[index + (code - first)];
+                    }
+                    index += n;
+                    first = (first + n) << 1;
+                    code <<= 1;
+                }
+                return -1;
+            }
+        };
+
+        // reassembles scanlines from the inflated stream, unfilters and converts them
+        class RowWriter {
+        public:
+            RowWriter(const Info &info, const std::array<uint8_t, 1024> &palette, uint8_t *dst,
+                      size_t dstPitch)
+                    : m_info(info), m_palette(palette), m_dst(dst), m_dstPitch(dstPitch) {
+                switch (info.colorType) {
+                    case COLOR_GRAY:
+                    case COLOR_PALETTE:
+                        m_bpp = 1u;
+                        break;
+                    case COLOR_GRAY_ALPHA:
+                        m_bpp = 2u;
+                        break;
+                    case COLOR_RGB:
+                        m_bpp = 3u;
+                        break;
+                    default:
+                        m_bpp = 4u;
+                        break;
+                }
+                m_rowBytes = static_cast<size_t>(info.width) * m_bpp;
+                // the previous row starts zeroed, as the filters expect for the first one
+                m_rows.assign(2u * (m_rowBytes + 1u), 0u);
+            }
+
+            bool write(const uint8_t *data, size_t size) {
+                while (size > 0u) {
+                    if (m_row == m_info.height) {
+                        return false; // more data than the image holds
+                    }
+                    uint8_t *cur = currentRow();
+                    const size_t n = std::min(size, m_rowBytes + 1u - m_fill);
+                    memcpy(cur + m_fill, data, n);
+                    m_fill += n;
+                    data += n;
+                    size -= n;
+                    if (m_fill == m_rowBytes + 1u) {
+                        if (!unfilter(cur[0], cur + 1u, previousRow() + 1u)) {
+                            return false;
+                        }
+                        emit(cur + 1u, m_dst + m_row * m_dstPitch);
+                        m_fill = 0u;
+                        ++m_row;
+                        m_current ^= 1u;
+                    }
+                }
+                return true;
+            }
+
+            bool complete() const {
+                return m_row == m_info.height;
+            }
+
+        private:
+            uint8_t *currentRow() {
+                return m_rows.data() + m_current * (m_rowBytes + 1u);
+            }
+
+            uint8_t *previousRow() {
+                return m_rows.data() + (m_current ^ 1u) * (m_rowBytes + 1u);
+            }
+
+            bool unfilter(uint8_t filter, uint8_t *cur, const uint8_t *prev) const {
+                const size_t bpp = m_bpp;
+                const size_t n = m_rowBytes;
+                switch (filter) {
+                    case 0u:
+                        break;
+                    case 1u:
+                        for (size_t i = bpp; i < n; ++i) {
+                            cur[i] = static_cast<uint8_t>(cur[i] + cur[i - bpp]);
+                        }
+                        break;
+                    case 2u:
+                        for (size_t i = 0u; i < n; ++i) {
+                            cur[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+                        }
+                        break;
+                    case 3u:
+                        for (size_t i = 0u; i < bpp; ++i) {
+                            cur[i] = static_cast<uint8_t>(cur[i] + (prev[i] >> 1u));
+                        }
+                        for (size_t i = bpp; i < n; ++i) {
+                            cur[i] = static_cast<uint8_t>(cur[i] + ((cur[i - bpp] + prev[i]) >> 1u));
+                        }
+                        break;
+                    case 4u:
+                        for (size_t i = 0u; i < bpp; ++i) {
+                            cur[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+                        }
+                        for (size_t i = bpp; i < n; ++i) {
+                            const int a = cur[i - bpp];
+                            const int b = prev[i];
+                            const int c = prev[i - bpp];
+                            const int p = a + b - c;
+                            const int pa = abs(p - a);
+                            const int pb = abs(p - b);
+                            const int pc = abs(p - c);
+                            const int predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                            cur[i] = static_cast<uint8_t>(cur[i] + predictor);
+                        }
+                        break;
+                    default:
+                        return false;
+                }
+                return true;
+            }
+
+            // dst may be write-combined, it is only written front to back
+            void emit(const uint8_t *src, uint8_t *dst) const {
+                const uint32_t width = m_info.width;
+                switch (m_info.colorType) {
+                    case COLOR_RGBA:
+                        memcpy(dst, src, m_rowBytes);
+                        break;
+                    case COLOR_RGB:
+                        PixelKernels::rgbToRgba(src, m_rowBytes, dst, m_dstPitch, width, 1u);
+                        break;
+                    case COLOR_PALETTE:
+                        for (uint32_t x = 0u; x < width; ++x) {
+                            memcpy(dst + x * 4u, &m_palette[src[x] * 4u], 4u);
+                        }
+                        break;
+                    case COLOR_GRAY:
+                        for (uint32_t x = 0u; x < width; ++x) {
+                            const uint8_t px[4] = {src[x], src[x], src[x], 255u};
+                            memcpy(dst + x * 4u, px, 4u);
+                        }
+                        break;
+                    default:
+                        for (uint32_t x = 0u; x < width; ++x) {
+                            const uint8_t g = src[x * 2u];
+                            const uint8_t px[4] = {g, g, g, src[x * 2u + 1u]};
+                            memcpy(dst + x * 4u, px, 4u);
+                        }
+                        break;
+                }
+            }
+
+            const Info &m_info;
+            const std::array<uint8_t, 1024> &m_palette;
+            uint8_t *m_dst;
+            size_t m_dstPitch;
+            size_t m_bpp = 4u;
+            size_t m_rowBytes = 0u;
+            std::vector<uint8_t> m_rows;
+            uint32_t m_current = 0u;
+            size_t m_fill = 0u;
+            uint32_t m_row = 0u;
+        };
+
+        // zlib stream inflater, output goes through a 2 * 32 KiB sliding window
+        class Inflater {
+        public:
+            Inflater(const std::vector<Span> &spans, RowWriter &writer)
+                    : m_reader(spans), m_writer(writer),
+                      m_window(2u * WINDOW_SIZE + MAX_MATCH) {
+            }
+
+            bool run() {
+                const uint32_t cmf = m_reader.read(8u);
+                const uint32_t flg = m_reader.read(8u);
+                if ((cmf & 15u) != 8u || ((cmf << 8u) | flg) % 31u != 0u || (flg & 0x20u)) {
+                    return false;
+                }
+                bool last = false;
+                while (!last) {
+                    last = m_reader.read(1u) != 0u;
+                    const uint32_t type = m_reader.read(2u);
+                    bool ok;
+                    if (type == 0u) {
+                        ok = stored();
+                    } else if (type == 1u) {
+                        ok = fixedCodes() && codes();
+                    } else if (type == 2u) {
+                        ok = dynamicCodes() && codes();
+                    } else {
+                        ok = false;
+                    }
+                    if (!ok || m_reader.overrun()) {
+                        return false;
+                    }
+                }
+                return flush();
+            }
+
+        private:
+            bool flush() {
+                const bool ok = m_writer.write(m_window.data() + m_flushed, m_pos - m_flushed);
+                m_flushed = m_pos;
+                return ok;
+            }
+
+            // keeps the last WINDOW_SIZE bytes for back references
+            bool slide() {
+                if (!flush()) {
+                    return false;
+                }
+                memmove(m_window.data(), m_window.data() + m_pos - WINDOW_SIZE, WINDOW_SIZE);
+                m_pos = WINDOW_SIZE;
+                m_flushed = WINDOW_SIZE;
+                return true;
+            }
+
+            bool stored() {
+                m_reader.alignToByte();
+                const uint32_t len = m_reader.read(16u);
+                const uint32_t nlen = m_reader.read(16u);
+                if ((len ^ 0xFFFFu) != nlen) {
+                    return false;
+                }
+                for (uint32_t i = 0u; i < len; ++i) {
+                    m_window[m_pos++] = static_cast<uint8_t>(m_reader.read(8u));
+                    if (m_pos >= 2u * WINDOW_SIZE && !slide()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool fixedCodes() {
+                uint8_t lengths[288 + 30];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                memset(lengths + 288, 5, 30);
+                return m_literals.build(lengths, 288u) && m_distances.build(lengths + 288, 30u);
+            }
+
+            bool dynamicCodes() {
+                const uint32_t literalCount = m_reader.read(5u) + 257u;
+                const uint32_t distanceCount = m_reader.read(5u) + 1u;
+                const uint32_t codeLengthCount = m_reader.read(4u) + 4u;
+                if (literalCount > 286u || distanceCount > 30u) {
+                    return false;
+                }
+
+                uint8_t codeLengths[19] = {};
+                for (uint32_t i = 0u; i < codeLengthCount; ++i) {
+                    codeLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(m_reader.read(3u));
+                }
+                Huffman codeLengthCode;
+                if (!codeLengthCode.build(codeLengths, 19u)) {
+                    return false;
+                }
+
+                uint8_t lengths[286 + 30];
+                const uint32_t total = literalCount + distanceCount;
+                for (uint32_t i = 0u; i < total;) {
+                    m_reader.refill();
+                    const int symbol = codeLengthCode.decode(m_reader);
+                    if (symbol < 0) {
+                        return false;
+                    }
+                    if (symbol < 16) {
+                        lengths[i++] = static_cast<uint8_t>(symbol);
+                        continue;
+                    }
+                    uint8_t value = 0u;
+                    uint32_t repeat;
+                    if (symbol == 16) {
+                        if (i == 0u) {
+                            return false;
+                        }
+                        value = lengths[i - 1u];
+                        repeat = 3u + m_reader.read(2u);
+                    } else if (symbol == 17) {
+                        repeat = 3u + m_reader.read(3u);
+                    } else {
+                        repeat = 11u + m_reader.read(7u);
+                    }
+                    if (i + repeat > total) {
+                        return false;
+                    }
+                    memset(lengths + i, value, repeat);
+                    i += repeat;
+                }
+                if (lengths[256] == 0u) {
+                    return false; // no end of block code
+                }
+                return m_literals.build(lengths, literalCount) &&
+                       m_distances.build(lengths + literalCount, distanceCount);
+            }
+
+            bool codes() {
+                uint8_t *window = m_window.data();
+                for (;;) {
+                    // one iteration consumes at most 15 + 5 + 15 + 13 bits
+                    m_reader.refill();
+                    const int symbol = m_literals.decode(m_reader);
+                    if (symbol < 256) {
+                        if (symbol < 0) {
+                            return false;
+                        }
+                        window[m_pos++] = static_cast<uint8_t>(symbol);
+                    } else if (symbol == 256) {
+                        return true;
+                    } else {
+                        const uint32_t lengthIndex = static_cast<uint32_t>(symbol) - 257u;
+                        if (lengthIndex >= 29u) {
+                            return false;
+                        }
+                        const uint32_t length = LENGTH_BASE[lengthIndex] +
+                                                m_reader.read(LENGTH_EXTRA[lengthIndex]);
+                        const int distanceIndex = m_distances.decode(m_reader);
+                        if (distanceIndex < 0 || distanceIndex >= 30) {
+                            return false;
+                        }
+                        const size_t distance = DIST_BASE[distanceIndex] +
+                                                m_reader.read(DIST_EXTRA[distanceIndex]);
+                        if (distance > m_pos) {
+                            return false;
+                        }
+                        const uint8_t *src = window + m_pos - distance;
+                        uint8_t *dst = window + m_pos;
+                        if (distance >= length) {
+                            memcpy(dst, src, length);
+                        } else {
+                            // overlapping run, byte order matters
+                            for (uint32_t i = 0u; i < length; ++i) {
+                                dst[i] = src[i];
+                            }
+                        }
+                        m_pos += length;
+                    }
+                    if (m_pos >= 2u * WINDOW_SIZE && !slide()) {
+                        return false;
+                    }
+                }
+            }
+
+            BitReader m_reader;
+            RowWriter &m_writer;
+            Huffman m_literals;
+            Huffman m_distances;
+            std::vector<uint8_t> m_window;
+            size_t m_pos = 0u;
+            size_t m_flushed = 0u;
+        };
+
+    }  // namespace
+
+    bool readInfo(const uint8_t *data, size_t size, Info &info) {
+        // signature, IHDR length and type, 13 bytes of IHDR
+        if (size < 8u + 8u + 13u || memcmp(data, SIGNATURE.data(), SIGNATURE.size()) ||
+            readBE32(data + 8u) != 13u || memcmp(data + 12u, "IHDR", 4u)) {
+            return false;
+        }
+        const uint8_t *ihdr = data + 16u;
+        info.width = readBE32(ihdr);
+        info.height = readBE32(ihdr + 4u);
+        info.bitDepth = ihdr[8];
+        info.colorType = ihdr[9];
+        info.interlace = ihdr[12];
+        return info.width > 0u && info.height > 0u && info.width <= MAX_DIMENSION &&
+               info.height <= MAX_DIMENSION;
+    }
+
+    bool isSupported(const Info &info) {
+        return info.bitDepth == 8u && info.interlace == 0u &&
+               (info.colorType == COLOR_GRAY || info.colorType == COLOR_RGB ||
+                info.colorType == COLOR_PALETTE || info.colorType == COLOR_GRAY_ALPHA ||
+                info.colorType == COLOR_RGBA);
+    }
+
+    bool decodeRGBA8(const uint8_t *data, size_t size, uint8_t *dst, size_t dstPitch) {
+        Info info;
+        if (!readInfo(data, size, info) || !isSupported(info)) {
+            return false;
+        }
+
+        // opaque black for indices past the palette
+        std::array<uint8_t, 1024> palette{};
+        for (size_t i = 3u; i < palette.size(); i += 4u) {
+            palette[i] = 255u;
+        }
+        std::vector<Span> idat;
+        size_t offset = SIGNATURE.size();
+        for (;;) {
+            if (size - offset < 12u) {
+                return false;
+            }
+            const uint32_t length = readBE32(data + offset);
+            const uint8_t *type = data + offset + 4u;
+            const uint8_t *payload = data + offset + 8u;
+            if (length > size - offset - 12u) {
+                return false;
+            }
+            if (!memcmp(type, "IDAT", 4u)) {
+                idat.push_back({payload, length});
+            } else if (!memcmp(type, "PLTE", 4u)) {
+                if (length % 3u != 0u || length > 768u) {
+                    return false;
+                }
+                for (uint32_t i = 0u; i < length / 3u; ++i) {
+                    memcpy(&palette[i * 4u], payload + i * 3u, 3u);
+                }
+            } else if (!memcmp(type, "tRNS", 4u)) {
+                // color keyed transparency is rare, leave it to stb_image
+                if (info.colorType != COLOR_PALETTE || length > 256u) {
+                    return false;
+                }
+                for (uint32_t i = 0u; i < length; ++i) {
+                    palette[i * 4u + 3u] = payload[i];
+                }
+            } else if (!memcmp(type, "IEND", 4u)) {
+                break;
+            }
+            offset += 12u + length;
+        }
+        if (idat.empty()) {
+            return false;
+        }
+
+        RowWriter writer(info, palette, dst, dstPitch);
+        Inflater inflater(idat, writer);
+        return inflater.run() && writer.complete();
+    }
+
+}  // namespace Png
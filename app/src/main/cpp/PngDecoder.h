@@ -0,0 +1,40 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_PNGDECODER_H
+#define ANDROIDVULKAN_PNGDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Streaming PNG decoder writing RGBA8 scanlines straight into a destination such as
+ * mapped staging memory. Only a 64 KiB inflate window and two filtered rows are kept,
+ * so decoding does not need an image sized intermediate. Destination rows are written
+ * once, front to back, and never read: write-combined memory is fine.
+ *
+ * Handles non-interlaced 8 bit gray, gray+alpha, RGB, RGBA and palette images, which
+ * covers what asset pipelines export; anything else is left to stb_image.
+ */
+namespace Png {
+
+    struct Info {
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        uint8_t bitDepth = 0u;
+        uint8_t colorType = 0u;
+        uint8_t interlace = 0u;
+    };
+
+    // parses the signature and IHDR, false if the data is not a PNG
+    bool readInfo(const uint8_t *data, size_t size, Info &info);
+
+    bool isSupported(const Info &info);
+
+    // false if the image is unsupported or corrupt, dst may be partially written then
+    bool decodeRGBA8(const uint8_t *data, size_t size, uint8_t *dst, size_t dstPitch);
+
+}  // namespace Png
+
+#endif //ANDROIDVULKAN_PNGDECODER_H
@@ -0,0 +1,90 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "StagingPool.h"
+#include "Utils.h"
+
+#include <cassert>
+
+StagingPool::~StagingPool() {
+    destroy();
+}
+
+void StagingPool::init(VkDevice device, MemoryAllocator &allocator) {
+    assert(device);
+    destroy();
+    m_device = device;
+    m_allocator = &allocator;
+}
+
+void StagingPool::destroy() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &buffer: m_free) {
+        destroyBuffer(buffer);
+    }
+    m_free.clear();
+    m_retainedSize = 0u;
+}
+
+StagingPool::Buffer StagingPool::acquire(VkDeviceSize size) {
+    assert(m_device);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // smallest released buffer that fits
+        auto best = m_free.end();
+        for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+            if (it->size >= size && (best == m_free.end() || it->size < best->size)) {
+                best = it;
+            }
+        }
+        if (best != m_free.end()) {
+            Buffer buffer = *best;
+            m_free.erase(best);
+            m_retainedSize -= buffer.size;
+            return buffer;
+        }
+    }
+
+    // power of two sizes keep the buffers reusable for images of similar size
+    VkDeviceSize bufferSize = MIN_BUFFER_SIZE;
+    while (bufferSize < size) {
+        bufferSize *= 2u;
+    }
+
+    Buffer buffer;
+    buffer.size = bufferSize;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bufferSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VK_CHECK(vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer.buffer));
+
+    buffer.mem = m_allocator->allocateForBuffer(buffer.buffer,
+                                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    assert(buffer.mem.mapped);
+    return buffer;
+}
+
+void StagingPool::release(Buffer &buffer) {
+    if (buffer.buffer == VK_NULL_HANDLE) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_retainedSize + buffer.size > MAX_RETAINED_SIZE) {
+        destroyBuffer(buffer);
+    } else {
+        m_retainedSize += buffer.size;
+        m_free.push_back(buffer);
+    }
+    buffer = {};
+}
+
+void StagingPool::destroyBuffer(Buffer &buffer) {
+    vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+    m_allocator->free(buffer.mem);
+    buffer = {};
+}
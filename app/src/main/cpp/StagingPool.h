@@ -0,0 +1,54 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_STAGINGPOOL_H
+#define ANDROIDVULKAN_STAGINGPOOL_H
+
+#include "MemoryAllocator.h"
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+/*
+ * StagingPool recycles persistently mapped HOST_VISIBLE transfer source buffers,
+ * so uploads do not create and destroy a buffer per image.
+ */
+class StagingPool {
+    static constexpr VkDeviceSize MIN_BUFFER_SIZE = 1024u * 1024u;
+    static constexpr VkDeviceSize MAX_RETAINED_SIZE = 64u * 1024u * 1024u;
+
+public:
+    struct Buffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation mem{};
+        VkDeviceSize size = 0u;
+
+        void *data() const {
+            return mem.mapped;
+        }
+    };
+
+    ~StagingPool();
+
+    void init(VkDevice device, MemoryAllocator &allocator);
+
+    void destroy();
+
+    // returns a buffer of at least size bytes, reusing a released one when possible
+    Buffer acquire(VkDeviceSize size);
+
+    // the GPU must be done reading from the buffer
+    void release(Buffer &buffer);
+
+private:
+    void destroyBuffer(Buffer &buffer);
+
+    VkDevice m_device = nullptr;
+    MemoryAllocator *m_allocator = nullptr;
+    std::vector<Buffer> m_free;
+    VkDeviceSize m_retainedSize = 0u;
+    std::mutex m_mutex;
+};
+
+#endif //ANDROIDVULKAN_STAGINGPOOL_H
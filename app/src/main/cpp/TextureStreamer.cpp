@@ -0,0 +1,483 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "TextureStreamer.h"
+#include "PixelKernels.h"
+#include "PngDecoder.h"
+#include "VulkanCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+TextureStreamer::~TextureStreamer() {
+    destroy();
+}
+
+void TextureStreamer::init(VulkanCore &core, StagingPool &stagingPool, VkFormat format) {
+    destroy();
+    m_core = &core;
+    m_stagingPool = &stagingPool;
+    m_format = format;
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(m_core->getPhysDevice(), m_format, &props);
+    const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                              VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    m_blitMips = (props.optimalTilingFeatures & blitFeatures) == blitFeatures;
+    LOGI("Mip chains are generated on the %s", m_blitMips ? "GPU" : "CPU");
+
+    // prefer the smallest blocks, ASTC and ETC2 on mobile GPUs, BC on desktop ones
+    const VkPhysicalDeviceFeatures &features = m_core->getEnabledFeatures();
+    m_variantSuffixes.clear();
+    if (m_compressedVariants) {
+        if (features.textureCompressionASTC_LDR &&
+            isSampleable(VK_FORMAT_ASTC_4x4_UNORM_BLOCK)) {
+            m_variantSuffixes.push_back(".astc.ktx2");
+        }
+        if (features.textureCompressionETC2 && isSampleable(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK)) {
+            m_variantSuffixes.push_back(".etc2.ktx2");
+        }
+        if (features.textureCompressionBC && isSampleable(VK_FORMAT_BC1_RGB_UNORM_BLOCK)) {
+            m_variantSuffixes.push_back(".bc.ktx2");
+        }
+        m_variantSuffixes.push_back(".ktx2");
+    }
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = m_core->getTransferQueueFamily();
+    VK_CHECK(vkCreateCommandPool(m_core->getDevice(), &poolInfo, nullptr, &m_commandPool));
+    m_timeline.init(core, m_core->getTransferQueue());
+
+    m_stop = false;
+    m_worker = std::thread(&TextureStreamer::run, this);
+}
+
+void TextureStreamer::destroy() {
+    if (!m_worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_jobs.clear();
+    }
+    m_jobCv.notify_all();
+    m_worker.join();
+
+    VkDevice device = m_core->getDevice();
+    for (auto &result: m_completed) {
+        vkDestroySemaphore(device, result.ready, nullptr);
+        vkDestroyImageView(device, result.view, nullptr);
+        vkDestroyImage(device, result.image, nullptr);
+        m_core->getAllocator().free(result.mem);
+    }
+    m_completed.clear();
+    m_pending = 0u;
+    vkDestroyCommandPool(device, m_commandPool, nullptr);
+    m_commandPool = VK_NULL_HANDLE;
+    // the worker retired every upload before it stopped
+    m_timeline.destroy();
+}
+
+uint32_t TextureStreamer::request(std::string path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32_t id = m_nextId++;
+    m_jobs.push_back({id, std::move(path)});
+    ++m_pending;
+    m_jobCv.notify_one();
+    return id;
+}
+
+std::vector<TextureStreamer::Result> TextureStreamer::takeCompleted() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::move(m_completed);
+}
+
+void TextureStreamer::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this]() { return m_pending == 0u; });
+}
+
+void TextureStreamer::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_jobs.empty() && !m_inFlight.empty() && !m_stop) {
+                // nothing to decode, park on the oldest upload instead of the condition
+                lock.unlock();
+                retire(true);
+                continue;
+            }
+            m_jobCv.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+            if (m_stop) {
+                break;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        retire(false);
+        upload(job);
+    }
+
+    while (!m_inFlight.empty()) {
+        retire(true);
+    }
+}
+
+void TextureStreamer::retire(bool wait) {
+    VkDevice device = m_core->getDevice();
+    while (!m_inFlight.empty()) {
+        InFlight &oldest = m_inFlight.front();
+        if (wait) {
+            m_timeline.wait(oldest.value);
+            wait = false;
+        } else if (!m_timeline.isComplete(oldest.value)) {
+            break;
+        }
+        vkFreeCommandBuffers(device, m_commandPool, 1, &oldest.cmd);
+        m_stagingPool->release(oldest.staging);
+        m_inFlight.pop_front();
+    }
+}
+
+bool TextureStreamer::isSampleable(VkFormat format) const {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(m_core->getPhysDevice(), format, &props);
+    const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (props.optimalTilingFeatures & required) == required;
+}
+
+std::vector<std::string> TextureStreamer::getVariantPaths(const std::string &path) const {
+    std::vector<std::string> paths;
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || path.compare(dot, std::string::npos, ".ktx2") == 0) {
+        return paths;
+    }
+    for (const char *suffix: m_variantSuffixes) {
+        paths.push_back(path.substr(0, dot) + suffix);
+    }
+    return paths;
+}
+
+void TextureStreamer::stageKtx2(const Ktx2::Texture &texture, Result &result,
+                                std::vector<VkBufferImageCopy> &regions,
+                                StagingPool::Buffer &staging) {
+    Ktx2::FormatInfo info;
+    Ktx2::getFormatInfo(texture.format, info);
+
+    result.format = texture.format;
+    result.width = static_cast<int32_t>(texture.width);
+    result.height = static_cast<int32_t>(texture.height);
+    result.generateMips = texture.generateMips && texture.format == m_format && m_blitMips;
+    result.mipLevels = result.generateMips ? Utils::getMipLevelCount(texture.width, texture.height)
+                                           : static_cast<uint32_t>(texture.levels.size());
+
+    // buffer offsets of block formats have to be multiples of the block size
+    const VkDeviceSize alignment = std::max(info.blockBytes, 4u);
+    VkDeviceSize stagingSize = 0u;
+    for (uint32_t level = 0u; level < texture.levels.size(); ++level) {
+        const Ktx2::Level &src = texture.levels[level];
+        VkBufferImageCopy region{};
+        region.bufferOffset = (stagingSize + alignment - 1u) / alignment * alignment;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        region.imageExtent = {src.width, src.height, 1};
+        regions.push_back(region);
+        stagingSize = region.bufferOffset + src.size;
+    }
+
+    staging = m_stagingPool->acquire(stagingSize);
+    auto *stagingData = static_cast<uint8_t *>(staging.data());
+    for (uint32_t level = 0u; level < texture.levels.size(); ++level) {
+        memcpy(stagingData + regions[level].bufferOffset, texture.levels[level].data,
+               texture.levels[level].size);
+    }
+}
+
+void TextureStreamer::stageDecoded(const std::string &path,
+                                   const Platform::AssetView &fileContent, Result &result,
+                                   std::vector<VkBufferImageCopy> &regions,
+                                   StagingPool::Buffer &staging) {
+    // only the header is read here, staging is sized before anything is decoded
+    int imgWidth, imgHeight, n = 4;
+    Png::Info png;
+    const bool isPng = Png::readInfo(fileContent.data(), fileContent.size(), png);
+    if (isPng) {
+        imgWidth = static_cast<int>(png.width);
+        imgHeight = static_cast<int>(png.height);
+    } else if (!stbi_info_from_memory(fileContent.data(), static_cast<int>(fileContent.size()),
+                                      &imgWidth, &imgHeight, &n)) {
+        LOGE("Failed to decode %s: %s", path.c_str(), stbi_failure_reason());
+        abort();
+    }
+
+    result.format = m_format;
+    result.width = imgWidth;
+    result.height = imgHeight;
+    result.mipLevels = Utils::getMipLevelCount(imgWidth, imgHeight);
+    result.generateMips = m_blitMips && result.mipLevels > 1u;
+
+    // one copy region per level present in the staging buffer
+    VkDeviceSize stagingSize = 0u;
+    const uint32_t uploadedLevels = result.generateMips ? 1u : result.mipLevels;
+    for (uint32_t level = 0u; level < uploadedLevels; ++level) {
+        const uint32_t levelWidth = std::max(static_cast<uint32_t>(imgWidth) >> level, 1u);
+        const uint32_t levelHeight = std::max(static_cast<uint32_t>(imgHeight) >> level, 1u);
+        VkBufferImageCopy region{};
+        region.bufferOffset = stagingSize;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        region.imageExtent = {levelWidth, levelHeight, 1};
+        regions.push_back(region);
+        stagingSize += static_cast<VkDeviceSize>(levelWidth) * levelHeight * 4u;
+    }
+
+    staging = m_stagingPool->acquire(stagingSize);
+    auto *stagingData = static_cast<uint8_t *>(staging.data());
+    const size_t rowBytes = static_cast<size_t>(imgWidth) * 4u;
+
+    // scanlines are inflated straight into staging unless level 0 is read back for mips
+    if (isPng && uploadedLevels == 1u && Png::isSupported(png) &&
+        Png::decodeRGBA8(fileContent.data(), fileContent.size(), stagingData, rowBytes)) {
+        return;
+    }
+
+    // stb_image fallback, RGB images are expanded by PixelKernels while staging
+    stbi_info_from_memory(fileContent.data(), static_cast<int>(fileContent.size()), &imgWidth,
+                          &imgHeight, &n);
+    const int channels = n == 3 ? 3 : 4;
+    unsigned char *imageData = stbi_load_from_memory(
+            fileContent.data(), static_cast<int>(fileContent.size()), &imgWidth,
+            &imgHeight, &n, channels);
+    if (!imageData || imgWidth != result.width || imgHeight != result.height) {
+        LOGE("Failed to decode %s: %s", path.c_str(), stbi_failure_reason());
+        abort();
+    }
+    const uint8_t *level0 = imageData;
+    std::vector<uint8_t> expanded;
+    if (channels == 3 && uploadedLevels == 1u) {
+        PixelKernels::rgbToRgba(imageData, imgWidth * 3u, stagingData, rowBytes, imgWidth,
+                                imgHeight);
+    } else {
+        if (channels == 3) {
+            // the mip chain below reads level 0 back
+            expanded.resize(rowBytes * imgHeight);
+            PixelKernels::rgbToRgba(imageData, imgWidth * 3u, expanded.data(), rowBytes,
+                                    imgWidth, imgHeight);
+            level0 = expanded.data();
+        }
+        PixelKernels::copyRows(level0, rowBytes, stagingData, rowBytes, rowBytes, imgHeight);
+    }
+    if (uploadedLevels > 1u) {
+        // filter from cached memory, the staging buffer is usually write-combined
+        std::vector<uint8_t> prev;
+        std::vector<uint8_t> next;
+        const uint8_t *src = level0;
+        for (uint32_t level = 1u; level < uploadedLevels; ++level) {
+            const VkExtent3D &srcExtent = regions[level - 1u].imageExtent;
+            const VkExtent3D &dstExtent = regions[level].imageExtent;
+            next.resize(static_cast<size_t>(dstExtent.width) * dstExtent.height * 4u);
+            Utils::downsampleRGBA8(src, srcExtent.width, srcExtent.height, next.data(),
+                                   dstExtent.width, dstExtent.height);
+            memcpy(stagingData + regions[level].bufferOffset, next.data(), next.size());
+            prev.swap(next);
+            src = prev.data();
+        }
+    }
+    stbi_image_free(imageData);
+}
+
+void TextureStreamer::upload(const Job &job) {
+    const auto start = std::chrono::steady_clock::now();
+    VkDevice device = m_core->getDevice();
+    const Platform::AssetSource &assets = m_core->getAssets();
+
+    Result result;
+    result.id = job.id;
+    result.needsAcquire = m_core->hasDedicatedTransferQueue();
+    InFlight inFlight{};
+    std::vector<VkBufferImageCopy> regions;
+
+    std::string source = job.path;
+    bool staged = false;
+    for (const auto &variant: getVariantPaths(job.path)) {
+        if (!assets.exists(variant.c_str())) {
+            continue;
+        }
+        const Platform::AssetView fileContent = assets.map(variant.c_str());
+        Ktx2::Texture texture;
+        if (!Ktx2::parse(fileContent.data(), fileContent.size(), texture) ||
+            !isSampleable(texture.format)) {
+            LOGE("Skipping %s, it cannot be sampled on this device", variant.c_str());
+            continue;
+        }
+        stageKtx2(texture, result, regions, inFlight.staging);
+        source = variant;
+        staged = true;
+        break;
+    }
+    if (!staged) {
+        const Platform::AssetView fileContent = assets.map(job.path.c_str());
+        Ktx2::Texture texture;
+        if (!Ktx2::isKtx2(fileContent.data(), fileContent.size())) {
+            stageDecoded(job.path, fileContent, result, regions, inFlight.staging);
+        } else if (Ktx2::parse(fileContent.data(), fileContent.size(), texture) &&
+                   isSampleable(texture.format)) {
+            stageKtx2(texture, result, regions, inFlight.staging);
+        } else {
+            LOGE("Failed to load %s", job.path.c_str());
+            abort();
+        }
+    }
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = result.format;
+    imageInfo.extent = {static_cast<uint32_t>(result.width),
+                        static_cast<uint32_t>(result.height), 1};
+    imageInfo.mipLevels = result.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (result.generateMips) {
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VK_CHECK(vkCreateImage(device, &imageInfo, nullptr, &result.image));
+    result.mem = m_core->getAllocator().allocateForImage(result.image,
+                                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                         VK_IMAGE_TILING_OPTIMAL);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = result.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = result.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, result.mipLevels, 0, 1};
+    VK_CHECK(vkCreateImageView(device, &viewInfo, nullptr, &result.view));
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VK_CHECK(vkAllocateCommandBuffers(device, &allocInfo, &inFlight.cmd));
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(inFlight.cmd, &beginInfo));
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = result.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, result.mipLevels, 0, 1};
+    vkCmdPipelineBarrier(inFlight.cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vkCmdCopyBufferToImage(inFlight.cmd, inFlight.staging.buffer, result.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+
+    // release half of the ownership transfer, visibility on the graphics side comes
+    // from the semaphore wait plus the matching acquire
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = result.generateMips ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                            : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    if (result.needsAcquire) {
+        barrier.srcQueueFamilyIndex = m_core->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = m_core->getQueueFamily();
+    }
+    vkCmdPipelineBarrier(inFlight.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                         &barrier);
+    VK_CHECK(vkEndCommandBuffer(inFlight.cmd));
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VK_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &result.ready));
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &inFlight.cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &result.ready;
+    inFlight.value = m_timeline.submit(submitInfo);
+    m_inFlight.push_back(inFlight);
+
+    LOGI("Streamed %s (%dx%d, format %d, %u mips) in %.2f ms", source.c_str(), result.width,
+         result.height, result.format, result.mipLevels,
+         std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start).count());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completed.push_back(result);
+        --m_pending;
+        m_idleCv.notify_all();
+    }
+    if (m_completionCallback) {
+        m_completionCallback();
+    }
+}
+
+void TextureStreamer::recordFinalize(VkCommandBuffer cmd, const Result &result) const {
+    if (!result.needsAcquire && result.generateMips) {
+        // the blits start at the transfer stage the semaphore wait already covers
+        Utils::generateMipmaps(cmd, result.image, result.width, result.height, result.mipLevels);
+        return;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.image = result.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, result.mipLevels, 0, 1};
+    if (result.needsAcquire) {
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = m_core->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = m_core->getQueueFamily();
+    } else {
+        // same family, the release already transitioned the image; the semaphore wait
+        // only covers WAIT_STAGE, the shader stages still need the dependency
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    VkPipelineStageFlags dstStage;
+    if (result.generateMips) {
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    } else {
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        dstStage = Utils::SHADER_READ_STAGES;
+    }
+    // chained after the semaphore wait, which happens at WAIT_STAGE
+    vkCmdPipelineBarrier(cmd, WAIT_STAGE, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    if (result.generateMips) {
+        Utils::generateMipmaps(cmd, result.image, result.width, result.height, result.mipLevels);
+    }
+}
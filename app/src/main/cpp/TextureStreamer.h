@@ -0,0 +1,141 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_TEXTURESTREAMER_H
+#define ANDROIDVULKAN_TEXTURESTREAMER_H
+
+#include "GpuTimeline.h"
+#include "Ktx2.h"
+#include "MemoryAllocator.h"
+#include "Platform.h"
+#include "StagingPool.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanCore;
+
+/*
+ * TextureStreamer decodes and uploads textures on a worker thread through the transfer
+ * queue. A finished upload is handed to the render thread together with a semaphore;
+ * the render thread records recordFinalize before the first use, which acquires the image
+ * from a dedicated transfer family and blits the mip chain (transfer queues cannot blit).
+ *
+ * With compressed variants enabled, a requested "name.png" first tries the GPU compressed
+ * variants, best format the device samples first: name.astc.ktx2, name.etc2.ktx2,
+ * name.bc.ktx2 and name.ktx2. Their blocks and prebuilt mips are copied as is; the PNG is
+ * decoded only as a fallback. Requests naming a .ktx2 file load it either way.
+ */
+class TextureStreamer {
+public:
+    // the graphics submission has to wait for Result::ready at this stage
+    static constexpr VkPipelineStageFlags WAIT_STAGE = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    struct Result {
+        uint32_t id = 0u;
+        VkImage image = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation mem{};
+        VkImageView view = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        int32_t width = 0;
+        int32_t height = 0;
+        uint32_t mipLevels = 1u;
+        VkSemaphore ready = VK_NULL_HANDLE; // owned by the receiver once taken
+        bool needsAcquire = false;
+        bool generateMips = false; // only level 0 was uploaded
+    };
+
+    ~TextureStreamer();
+
+    // Called on the worker thread whenever an upload becomes available to takeCompleted,
+    // lets an idle render loop wake up. Has to be set before init
+    void setCompletionCallback(std::function<void()> callback) {
+        m_completionCallback = std::move(callback);
+    }
+
+    // Lossy variants replace the source image, so they are opt-in. Has to be set before init
+    void setCompressedVariants(bool enabled) {
+        m_compressedVariants = enabled;
+    }
+
+    // format is used for decoded images, KTX2 files carry their own
+    void init(VulkanCore &core, StagingPool &stagingPool, VkFormat format);
+
+    // stops the worker, uploads not taken yet are destroyed
+    void destroy();
+
+    // queues an asset for decoding and upload, returns the id reported in Result
+    uint32_t request(std::string path);
+
+    // uploads submitted since the last call, never blocks on the GPU
+    std::vector<Result> takeCompleted();
+
+    // blocks until every requested texture has been submitted
+    void waitIdle();
+
+    // ownership acquire matching the release on the transfer queue plus mip generation, or
+    // the dependency of the shader stages on the semaphore wait when neither is needed.
+    // Has to be recorded on the graphics queue after waiting for Result::ready
+    void recordFinalize(VkCommandBuffer cmd, const Result &result) const;
+
+private:
+    struct Job {
+        uint32_t id;
+        std::string path;
+    };
+
+    struct InFlight {
+        uint64_t value; // on m_timeline
+        VkCommandBuffer cmd;
+        StagingPool::Buffer staging;
+    };
+
+    void run();
+
+    void upload(const Job &job);
+
+    bool isSampleable(VkFormat format) const;
+
+    // KTX2 variants of an asset worth probing on this device, best first
+    std::vector<std::string> getVariantPaths(const std::string &path) const;
+
+    // fill the staging buffer and copy regions, result gets its format, size and mip setup
+    void stageKtx2(const Ktx2::Texture &texture, Result &result,
+                   std::vector<VkBufferImageCopy> &regions, StagingPool::Buffer &staging);
+
+    void stageDecoded(const std::string &path, const Platform::AssetView &fileContent,
+                      Result &result, std::vector<VkBufferImageCopy> &regions,
+                      StagingPool::Buffer &staging);
+
+    // recycles staging buffers and command buffers of finished uploads
+    void retire(bool wait);
+
+    VulkanCore *m_core = nullptr;
+    StagingPool *m_stagingPool = nullptr;
+    VkFormat m_format = VK_FORMAT_UNDEFINED;
+    bool m_blitMips = false; // otherwise the chain is built on the CPU
+    bool m_compressedVariants = false;
+    std::vector<const char *> m_variantSuffixes;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE; // worker thread only
+    GpuTimeline m_timeline; // transfer queue, worker thread only
+    std::deque<InFlight> m_inFlight; // worker thread only
+
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_jobCv;
+    std::condition_variable m_idleCv;
+    std::deque<Job> m_jobs;
+    std::vector<Result> m_completed;
+    uint32_t m_pending = 0u;
+    uint32_t m_nextId = 1u;
+    bool m_stop = false;
+    std::function<void()> m_completionCallback;
+};
+
+#endif //ANDROIDVULKAN_TEXTURESTREAMER_H
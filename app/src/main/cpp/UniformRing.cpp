@@ -0,0 +1,71 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#include "UniformRing.h"
+#include "Utils.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace {
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1u) / alignment * alignment;
+    }
+}
+
+void UniformRing::init(VkDevice device, MemoryAllocator &allocator,
+                       VkDeviceSize minOffsetAlignment, VkDeviceSize frameCapacity,
+                       uint32_t frameCount) {
+    assert(device && frameCapacity > 0u && frameCount > 0u);
+    m_device = device;
+    m_allocator = &allocator;
+    m_alignment = minOffsetAlignment > 0u ? minOffsetAlignment : 1u;
+    m_frameCapacity = alignUp(frameCapacity, m_alignment);
+    m_frameCount = frameCount;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_frameCapacity * m_frameCount;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VK_CHECK(vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer));
+
+    m_memory = m_allocator->allocateForBuffer(m_buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    assert(m_memory.mapped);
+
+    m_frameBegin = 0u;
+    m_head = 0u;
+}
+
+void UniformRing::destroy() {
+    if (m_buffer == VK_NULL_HANDLE) {
+        return;
+    }
+    vkDestroyBuffer(m_device, m_buffer, nullptr);
+    m_allocator->free(m_memory);
+    m_buffer = VK_NULL_HANDLE;
+    m_frameBegin = 0u;
+    m_head = 0u;
+}
+
+void UniformRing::beginFrame(uint32_t frameIndex) {
+    assert(frameIndex < m_frameCount);
+    m_frameBegin = m_frameCapacity * frameIndex;
+    m_head = m_frameBegin;
+}
+
+uint32_t UniformRing::push(const void *data, VkDeviceSize size) {
+    const VkDeviceSize offset = alignUp(m_head, m_alignment);
+    if (offset + size > m_frameBegin + m_frameCapacity) {
+        LOGE("Uniform ring partition overflow: %llu bytes requested, %llu per frame",
+             static_cast<unsigned long long>(size),
+             static_cast<unsigned long long>(m_frameCapacity));
+        abort();
+    }
+
+    memcpy(static_cast<uint8_t *>(m_memory.mapped) + offset, data, size);
+    m_head = offset + size;
+    return static_cast<uint32_t>(offset);
+}
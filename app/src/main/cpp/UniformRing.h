@@ -0,0 +1,52 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+#ifndef ANDROIDVULKAN_UNIFORMRING_H
+#define ANDROIDVULKAN_UNIFORMRING_H
+
+#include "MemoryAllocator.h"
+#include <vulkan/vulkan.h>
+
+/*
+ * UniformRing is one persistently mapped uniform buffer split into a partition per frame
+ * in flight. Each frame writes its constants linearly into its own partition and binds
+ * them through dynamic offsets, the partition is reused once the frame's submission completed.
+ */
+class UniformRing {
+public:
+    void init(VkDevice device, MemoryAllocator &allocator, VkDeviceSize minOffsetAlignment,
+              VkDeviceSize frameCapacity, uint32_t frameCount);
+
+    void destroy();
+
+    // rewinds the partition of the given frame, its previous contents must be consumed
+    void beginFrame(uint32_t frameIndex);
+
+    // copies data into the current partition and returns its dynamic offset
+    uint32_t push(const void *data, VkDeviceSize size);
+
+    template<typename T>
+    uint32_t push(const T &data) {
+        return push(&data, sizeof(T));
+    }
+
+    VkBuffer getBuffer() const {
+        return m_buffer;
+    }
+
+private:
+    VkDevice m_device = nullptr;
+    MemoryAllocator *m_allocator = nullptr;
+    VkBuffer m_buffer = VK_NULL_HANDLE;
+    MemoryAllocator::Allocation m_memory{};
+
+    VkDeviceSize m_alignment = 1u;
+    VkDeviceSize m_frameCapacity = 0u;
+    uint32_t m_frameCount = 0u;
+
+    VkDeviceSize m_frameBegin = 0u;
+    VkDeviceSize m_head = 0u;
+};
+
+#endif //ANDROIDVULKAN_UNIFORMRING_H
@@ -4,31 +4,27 @@
 
 #include "Utils.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <climits>
+#include <cstring>
 
 namespace Utils {
-    std::vector<uint8_t> LoadBinaryFileToVector(const char *file_path,
-                                                AAssetManager *assetManager) {
-        std::vector<uint8_t> file_content;
-        assert(assetManager);
-        AAsset *file =
-                AAssetManager_open(assetManager, file_path, AASSET_MODE_BUFFER);
-        size_t file_length = AAsset_getLength(file);
-
-        file_content.resize(file_length);
-
-        AAsset_read(file, file_content.data(), file_length);
-        AAsset_close(file);
-        return file_content;
-    }
-
-    VkShaderModule createShaderModule(VkDevice device, const std::vector<uint8_t> &code) {
+    VkShaderModule createShaderModule(VkDevice device, const uint8_t *code, size_t size) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-
-        createInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+        createInfo.codeSize = size;
+
+        // pCode has to be 4 byte aligned, which zipalign only guarantees for stored entries
+        std::vector<uint32_t> aligned;
+        if (reinterpret_cast<uintptr_t>(code) % alignof(uint32_t) != 0u) {
+            aligned.resize((size + 3u) / 4u);
+            memcpy(aligned.data(), code, size);
+            createInfo.pCode = aligned.data();
+        } else {
+            createInfo.pCode = reinterpret_cast<const uint32_t *>(code);
+        }
         VkShaderModule shaderModule;
         VK_CHECK(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
 
@@ -141,6 +137,86 @@ namespace Utils {
                              &imageMemoryBarrier);
     }
 
+    uint32_t getMipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t levels = 1u;
+        for (uint32_t size = std::max(width, height); size > 1u; size >>= 1u) {
+            ++levels;
+        }
+        return levels;
+    }
+
+    void generateMipmaps(VkCommandBuffer cmdBuffer, VkImage image, uint32_t width,
+                         uint32_t height, uint32_t mipLevels) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        int32_t srcWidth = static_cast<int32_t>(width);
+        int32_t srcHeight = static_cast<int32_t>(height);
+        for (uint32_t level = 1u; level < mipLevels; ++level) {
+            const int32_t dstWidth = std::max(srcWidth / 2, 1);
+            const int32_t dstHeight = std::max(srcHeight / 2, 1);
+
+            barrier.subresourceRange.baseMipLevel = level - 1u;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                                 &barrier);
+
+            VkImageBlit blit{};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1u, 0, 1};
+            blit.srcOffsets[1] = {srcWidth, srcHeight, 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            blit.dstOffsets[1] = {dstWidth, dstHeight, 1};
+            vkCmdBlitImage(cmdBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_READ_STAGES,
+                                 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            srcWidth = dstWidth;
+            srcHeight = dstHeight;
+        }
+
+        // the last level was only written
+        barrier.subresourceRange.baseMipLevel = mipLevels - 1u;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_READ_STAGES, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void downsampleRGBA8(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight,
+                         uint8_t *dst, uint32_t dstWidth, uint32_t dstHeight) {
+        for (uint32_t y = 0u; y < dstHeight; ++y) {
+            const uint8_t *row0 = src + static_cast<size_t>(std::min(y * 2u, srcHeight - 1u)) *
+                                        srcWidth * 4u;
+            const uint8_t *row1 = src + static_cast<size_t>(std::min(y * 2u + 1u, srcHeight - 1u)) *
+                                        srcWidth * 4u;
+            uint8_t *out = dst + static_cast<size_t>(y) * dstWidth * 4u;
+            for (uint32_t x = 0u; x < dstWidth; ++x) {
+                const uint32_t x0 = std::min(x * 2u, srcWidth - 1u) * 4u;
+                const uint32_t x1 = std::min(x * 2u + 1u, srcWidth - 1u) * 4u;
+                for (uint32_t c = 0u; c < 4u; ++c) {
+                    out[x * 4u + c] = static_cast<uint8_t>(
+                            (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2u) / 4u);
+                }
+            }
+        }
+    }
+
     void VulkanCheckValidationLayerSupport() {
         uint32_t layerCount;
         vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
@@ -244,6 +320,11 @@ namespace Utils {
             vkGetPhysicalDeviceQueueFamilyProperties(PhysDev, &NumQFamily,
                                                      &(PhysDevices.m_qFamilyProps[i][0]));
 
+            // headless devices have no surface to query
+            if (Surface == VK_NULL_HANDLE) {
+                continue;
+            }
+
             for (size_t q = 0; q < NumQFamily; q++) {
                 res = vkGetPhysicalDeviceSurfaceSupportKHR(PhysDev, q, Surface,
                                                            &(PhysDevices.m_qSupportsPresent[i][q]));
@@ -298,6 +379,9 @@ namespace Utils {
         if (pretransformFlag & VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR) {
             // mat is set to a 90 deg rotation matrix
             mat = {0., 1., 0., 0., -1., 0, 0., 0., 0., 0., 1., 0., 0., 0., 0., 1.};
+        } else if (pretransformFlag & VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR) {
+            // mat is set to 180 deg rotation matrix
+            mat = {-1., 0., 0., 0., 0., -1., 0., 0., 0., 0., 1., 0., 0., 0., 0., 1.};
         } else if (pretransformFlag & VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR) {
             // mat is set to 270 deg rotation matrix
             mat = {0., -1., 0., 0., 1., 0, 0., 0., 0., 0., 1., 0., 0., 0., 0., 1.};
@@ -5,17 +5,11 @@
 #ifndef ANDROIDVULKAN_UTILS_H
 #define ANDROIDVULKAN_UTILS_H
 
-#include <android/log.h>
-#include <android/asset_manager.h>
-#include <android/native_window.h>
-#include <android/native_window_jni.h>
+#include "Platform.h"
+#include <array>
 #include <vector>
 #include <vulkan/vulkan.h>
 
-#define LOG_TAG "my_engine"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #define VK_CHECK(err)                                                                   \
   do {                                                                                  \
     if (err != VK_SUCCESS) {                                                            \
@@ -28,6 +22,10 @@
 
 namespace Utils {
 
+    // stages sampling textures: the graphics pass and the HSV compute pass
+    constexpr VkPipelineStageFlags SHADER_READ_STAGES =
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
     struct VulkanPhysicalDevices {
         std::vector<VkPhysicalDevice> m_devices;
         std::vector<VkPhysicalDeviceProperties> m_devProps;
@@ -38,7 +36,8 @@ namespace Utils {
         std::vector<std::vector<VkPresentModeKHR>> m_presentModes;
     };
 
-    VkShaderModule createShaderModule(VkDevice device, const std::vector<uint8_t> &code);
+    // code can point straight into a mapped asset, it is only copied if misaligned
+    VkShaderModule createShaderModule(VkDevice device, const uint8_t *code, size_t size);
 
     uint32_t findMemoryType(VkPhysicalDevice physDevice, uint32_t typeFilter,
                             VkMemoryPropertyFlags properties);
@@ -54,6 +53,18 @@ namespace Utils {
                         VkPipelineStageFlags srcStages,
                         VkPipelineStageFlags destStages);
 
+    // number of levels of a full mip chain down to 1x1
+    uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+
+    // Blits every level from the previous one. All levels have to be in
+    // TRANSFER_DST_OPTIMAL, they are left in SHADER_READ_ONLY_OPTIMAL
+    void generateMipmaps(VkCommandBuffer cmdBuffer, VkImage image, uint32_t width,
+                         uint32_t height, uint32_t mipLevels);
+
+    // CPU 2x2 box filter for RGBA8, odd edges are clamped; fallback when blits are unsupported
+    void downsampleRGBA8(const uint8_t *src, uint32_t srcWidth, uint32_t srcHeight,
+                         uint8_t *dst, uint32_t dstWidth, uint32_t dstHeight);
+
     void VulkanCheckValidationLayerSupport();
 
     void VulkanEnumExtProps(std::vector<VkExtensionProperties> &ExtProps);
@@ -65,12 +76,9 @@ namespace Utils {
                                 const VkMemoryRequirements &memRequirements,
                                 VkMemoryPropertyFlags properties);
 
-    std::vector<uint8_t> LoadBinaryFileToVector(const char *file_path,
-                                                AAssetManager *assetManager);
-
     /*
-    * getPrerotationMatrix handles screen rotation with 3 hardcoded rotation
-    * matrices (detailed below). We skip the 180 degrees rotation.
+    * getPrerotationMatrix handles screen rotation with 4 hardcoded rotation
+    * matrices (detailed below), one per rotation a surface can report.
     */
     void getPrerotationMatrix(const VkSurfaceCapabilitiesKHR &capabilities,
                               const VkSurfaceTransformFlagBitsKHR &pretransformFlag,
@@ -4,8 +4,36 @@
 
 #include "VulkanCore.h"
 
+#include <cstring>
+
 using namespace Utils;
 
+static bool containsExtension(const std::vector<VkExtensionProperties> &props,
+                              const char *name) {
+    for (const auto &prop: props) {
+        if (strcmp(prop.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasInstanceExtension(const char *name) {
+    uint32_t count = 0;
+    VK_CHECK(vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
+    std::vector<VkExtensionProperties> props(count);
+    VK_CHECK(vkEnumerateInstanceExtensionProperties(nullptr, &count, props.data()));
+    return containsExtension(props, name);
+}
+
+static bool hasDeviceExtension(VkPhysicalDevice device, const char *name) {
+    uint32_t count = 0;
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr));
+    std::vector<VkExtensionProperties> props(count);
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, props.data()));
+    return containsExtension(props, name);
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL
 MyDebugReportCallback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType,
                       uint64_t object, size_t location, int32_t messageCode,
@@ -15,6 +43,9 @@ MyDebugReportCallback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT ob
 }
 
 void VulkanCore::clean() {
+    if (!m_inst) {
+        return;
+    }
 #ifdef _DEBUG
     // Get the address to the vkCreateDebugReportCallbackEXT function
     auto func =
@@ -25,25 +56,42 @@ void VulkanCore::clean() {
     }
 #endif
 
+    m_allocator.destroy();
     vkDestroyDevice(m_device, nullptr);
     vkDestroySurfaceKHR(m_inst, m_surface, nullptr);
     vkDestroyInstance(m_inst, nullptr);
+
+    m_device = nullptr;
+    m_surface = VK_NULL_HANDLE;
+    m_surfaceState = {};
+    m_enabledFeatures = {};
+    m_inst = nullptr;
+    m_physDevices = {};
+    m_gfxDevIndex = -1;
+    m_gfxQueueFamily = -1;
+    m_transferQueueFamily = -1;
+    m_gfxQueue = nullptr;
+    m_transferQueue = nullptr;
+    m_hasProperties2 = false;
+    m_timelineSemaphores = false;
 }
 
 VulkanCore::~VulkanCore() {
     clean();
 }
 
-void VulkanCore::init(ANativeWindow *window, AAssetManager *assetManager) {
-    assert(window && assetManager);
+void VulkanCore::init(std::unique_ptr<Platform::SurfaceProvider> surfaceProvider,
+                      std::unique_ptr<Platform::AssetSource> assets) {
+    assert(surfaceProvider && assets);
 
     // reset if needed
-    if (m_winController || m_assetManager) {
+    if (m_inst) {
         clean();
     }
 
-    m_winController.reset(window);
-    m_assetManager = assetManager;
+    m_headless = false;
+    m_surfaceProvider = std::move(surfaceProvider);
+    m_assets = std::move(assets);
 
     std::vector<VkExtensionProperties> ExtProps;
     VulkanEnumExtProps(ExtProps);
@@ -59,16 +107,30 @@ void VulkanCore::init(ANativeWindow *window, AAssetManager *assetManager) {
     createLogicalDevice();
 }
 
+void VulkanCore::initHeadless(std::unique_ptr<Platform::AssetSource> assets) {
+    assert(assets);
+
+    // reset if needed
+    if (m_inst) {
+        clean();
+    }
+
+    m_headless = true;
+    m_surfaceProvider.reset();
+    m_assets = std::move(assets);
+
+    VulkanCheckValidationLayerSupport();
+
+    createInstance();
+
+    VulkanGetPhysicalDevices(m_inst, VK_NULL_HANDLE, m_physDevices);
+    selectPhysicalDevice();
+    createLogicalDevice();
+}
+
 void VulkanCore::createSurface() {
-    assert(m_winController);
-    const VkAndroidSurfaceCreateInfoKHR create_info{
-            .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
-            .pNext = nullptr,
-            .flags = 0,
-            .window = m_winController.get()};
-
-    VK_CHECK(vkCreateAndroidSurfaceKHR(m_inst, &create_info,
-                                       nullptr, &m_surface));
+    assert(m_surfaceProvider);
+    m_surface = m_surfaceProvider->createSurface(m_inst);
     LOGD("Surface created");
 }
 
@@ -77,28 +139,34 @@ VkPhysicalDevice VulkanCore::getPhysDevice() const {
     return m_physDevices.m_devices[m_gfxDevIndex];
 }
 
+const VkPhysicalDeviceProperties &VulkanCore::getPhysDeviceProps() const {
+    assert(m_gfxDevIndex >= 0);
+    return m_physDevices.m_devProps[m_gfxDevIndex];
+}
+
 const VkSurfaceFormatKHR &VulkanCore::getSurfaceFormat() const {
     assert(m_gfxDevIndex >= 0);
     return m_physDevices.m_surfaceFormats[m_gfxDevIndex][0];
 }
 
-VkSurfaceCapabilitiesKHR VulkanCore::getSurfaceCaps() {
-    assert(m_gfxDevIndex >= 0);
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
-            getPhysDevice(), m_surface,
-            const_cast<VkSurfaceCapabilitiesKHR *>(&(m_physDevices.m_surfaceCaps[m_gfxDevIndex])));
+const VulkanCore::SurfaceState &VulkanCore::refreshSurfaceState() {
+    assert(m_gfxDevIndex >= 0 && m_surface != VK_NULL_HANDLE);
+    VkSurfaceCapabilitiesKHR &capabilities = m_physDevices.m_surfaceCaps[m_gfxDevIndex];
+    VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(getPhysDevice(), m_surface,
+                                                       &capabilities));
 
-    VkSurfaceCapabilitiesKHR capabilities = m_physDevices.m_surfaceCaps[m_gfxDevIndex];
+    m_surfaceState.caps = capabilities;
+    m_surfaceState.transform = capabilities.currentTransform;
     if (capabilities.currentTransform & VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR ||
         capabilities.currentTransform & VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR) {
         // Swap to get identity width and height
-        uint32_t width = capabilities.currentExtent.width;
-        uint32_t height = capabilities.currentExtent.height;
-        capabilities.currentExtent.height = width;
-        capabilities.currentExtent.width = height;
+        m_surfaceState.caps.currentExtent.width = capabilities.currentExtent.height;
+        m_surfaceState.caps.currentExtent.height = capabilities.currentExtent.width;
     }
+    getPrerotationMatrix(m_surfaceState.caps, m_surfaceState.transform,
+                         m_surfaceState.preRotation);
 
-    return capabilities;
+    return m_surfaceState;
 }
 
 void VulkanCore::selectPhysicalDevice() {
@@ -115,7 +183,7 @@ void VulkanCore::selectPhysicalDevice() {
                  (flags & VK_QUEUE_SPARSE_BINDING_BIT) ? "Yes" : "No");
 
             if ((flags & VK_QUEUE_GRAPHICS_BIT) && (m_gfxDevIndex == -1)) {
-                if (!m_physDevices.m_qSupportsPresent[i][j]) {
+                if (!m_headless && !m_physDevices.m_qSupportsPresent[i][j]) {
                     LOGI("Present is not supported");
                     continue;
                 }
@@ -132,6 +200,20 @@ void VulkanCore::selectPhysicalDevice() {
         LOGE("No GFX device found!");
         abort();
     }
+
+    // a transfer-only family is usually backed by a DMA engine running beside graphics
+    m_transferQueueFamily = m_gfxQueueFamily;
+    const auto &families = m_physDevices.m_qFamilyProps[m_gfxDevIndex];
+    for (size_t j = 0u; j < families.size(); ++j) {
+        const VkQueueFlags flags = families[j].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) &&
+            !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            m_transferQueueFamily = j;
+            break;
+        }
+    }
+    LOGI("Using transfer queue family %d%s\n", m_transferQueueFamily,
+         hasDedicatedTransferQueue() ? "" : " (shared with GFX)");
 }
 
 void VulkanCore::createInstance() {
@@ -141,11 +223,21 @@ void VulkanCore::createInstance() {
     appInfo.engineVersion = 1;
     appInfo.apiVersion = VK_API_VERSION_1_0;
 
-    const char *pInstExt[] = {
+    std::vector<const char *> instExt = {
 #ifdef _DEBUG
             VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
 #endif
-            "VK_KHR_surface", "VK_KHR_android_surface"};
+    };
+    if (!m_headless) {
+        instExt.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+        instExt.push_back(m_surfaceProvider->getInstanceExtension());
+    }
+    // the instance stays at 1.0, device features beyond it are chained through this one
+    const char *properties2 = VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME;
+    m_hasProperties2 = hasInstanceExtension(properties2);
+    if (m_hasProperties2) {
+        instExt.push_back(properties2);
+    }
 
 #ifdef _DEBUG
     const char *pInstLayers[] = {"VK_LAYER_KHRONOS_validation"};
@@ -158,8 +250,8 @@ void VulkanCore::createInstance() {
     instInfo.enabledLayerCount = ARRAY_SIZE(pInstLayers);
     instInfo.ppEnabledLayerNames = pInstLayers;
 #endif
-    instInfo.enabledExtensionCount = ARRAY_SIZE(pInstExt);
-    instInfo.ppEnabledExtensionNames = pInstExt;
+    instInfo.enabledExtensionCount = static_cast<uint32_t>(instExt.size());
+    instInfo.ppEnabledExtensionNames = instExt.data();
 
     VkResult res = vkCreateInstance(&instInfo, nullptr, &m_inst);
     LOGD("vkCreateInstance %d\n", res);
@@ -181,10 +273,13 @@ void VulkanCore::createInstance() {
     callbackCreateInfo.pfnCallback = &MyDebugReportCallback;
     callbackCreateInfo.pUserData = nullptr;
 
-    VkDebugReportCallbackEXT callback;
-    res = my_vkCreateDebugReportCallbackEXT(m_inst, &callbackCreateInfo, nullptr, &callback);
-    LOGI("my_vkCreateDebugReportCallbackEXT %d", res);
-    VK_CHECK(res);
+    // not every validation layer build exposes VK_EXT_debug_report
+    if (my_vkCreateDebugReportCallbackEXT) {
+        VkDebugReportCallbackEXT callback;
+        res = my_vkCreateDebugReportCallbackEXT(m_inst, &callbackCreateInfo, nullptr, &callback);
+        LOGI("my_vkCreateDebugReportCallbackEXT %d", res);
+        VK_CHECK(res);
+    }
 #endif
 }
 
@@ -197,21 +292,73 @@ void VulkanCore::createLogicalDevice() {
     qInfo.pQueuePriorities = &qPriorities;
     qInfo.queueFamilyIndex = m_gfxQueueFamily;
 
-    const char *pDevExt[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<VkDeviceQueueCreateInfo> queueInfos = {qInfo};
+    if (hasDedicatedTransferQueue()) {
+        qInfo.queueFamilyIndex = m_transferQueueFamily;
+        queueInfos.push_back(qInfo);
+    }
+
+    std::vector<const char *> devExt;
+    if (!m_headless) {
+        devExt.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
-    VkPhysicalDeviceFeatures deviceFeatures{};
-    deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // software rasterizers do not necessarily expose anisotropic filtering,
+    // block compression support differs between mobile and desktop GPUs
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(getPhysDevice(), &supportedFeatures);
+
+    m_enabledFeatures = {};
+    m_enabledFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    m_enabledFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    m_enabledFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+    m_enabledFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+
+    // the feature is mandatory wherever the extension is exposed, no need to query it
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    m_timelineSemaphores =
+            m_hasProperties2 &&
+            hasDeviceExtension(getPhysDevice(), VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    if (m_timelineSemaphores) {
+        devExt.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    }
+    LOGI("Timeline semaphores %s", m_timelineSemaphores ? "enabled" : "not supported");
 
     VkDeviceCreateInfo devInfo = {};
     devInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    devInfo.enabledExtensionCount = ARRAY_SIZE(pDevExt);
-    devInfo.ppEnabledExtensionNames = pDevExt;
-    devInfo.queueCreateInfoCount = 1;
-    devInfo.pQueueCreateInfos = &qInfo;
-    devInfo.pEnabledFeatures = &deviceFeatures;
+    devInfo.pNext = m_timelineSemaphores ? &timelineFeatures : nullptr;
+    devInfo.enabledExtensionCount = static_cast<uint32_t>(devExt.size());
+    devInfo.ppEnabledExtensionNames = devExt.empty() ? nullptr : devExt.data();
+    devInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
+    devInfo.pQueueCreateInfos = queueInfos.data();
+    devInfo.pEnabledFeatures = &m_enabledFeatures;
 
     VkResult res = vkCreateDevice(getPhysDevice(), &devInfo, nullptr, &m_device);
 
     LOGD("vkCreateDevice %d\n", res);
     VK_CHECK(res);
+
+    vkGetDeviceQueue(m_device, m_gfxQueueFamily, 0, &m_gfxQueue);
+    vkGetDeviceQueue(m_device, m_transferQueueFamily, 0, &m_transferQueue);
+
+    m_allocator.init(getPhysDevice(), m_device);
+}
+
+VkResult VulkanCore::queueSubmit(VkQueue queue, uint32_t submitCount,
+                                 const VkSubmitInfo *submits, VkFence fence) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return vkQueueSubmit(queue, submitCount, submits, fence);
+}
+
+VkResult VulkanCore::queuePresent(const VkPresentInfoKHR *presentInfo) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return vkQueuePresentKHR(m_gfxQueue, presentInfo);
+}
+
+void VulkanCore::waitIdle() {
+    // vkDeviceWaitIdle requires every queue of the device to be externally synchronized
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    vkDeviceWaitIdle(m_device);
 }
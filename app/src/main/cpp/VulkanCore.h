@@ -5,35 +5,94 @@
 #ifndef ANDROIDVULKAN_VULKANCORE_H
 #define ANDROIDVULKAN_VULKANCORE_H
 
+#include "MemoryAllocator.h"
+#include "Platform.h"
 #include "Utils.h"
 #include <assert.h>
+#include <memory>
+#include <mutex>
 #include <vulkan/vulkan.h>
-#include <vulkan/vulkan_android.h>
 
 class VulkanCore {
-    struct ANativeWindowDeleter {
-        void operator()(ANativeWindow *window) { ANativeWindow_release(window); }
+public:
+    // surface properties cached between swapchain (re)creations
+    struct SurfaceState {
+        VkSurfaceCapabilitiesKHR caps{}; // currentExtent is swapped to identity orientation
+        VkSurfaceTransformFlagBitsKHR transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        std::array<float, 16> preRotation{};
     };
 
-public:
     ~VulkanCore();
 
-    void init(ANativeWindow *window, AAssetManager *assetManager);
+    void init(std::unique_ptr<Platform::SurfaceProvider> surfaceProvider,
+              std::unique_ptr<Platform::AssetSource> assets);
+
+    // Offscreen initialization: no surface, no swapchain and no present support required,
+    // so it runs on software ICDs such as lavapipe or SwiftShader
+    void initHeadless(std::unique_ptr<Platform::AssetSource> assets);
+
+    void clean();
 
     VkPhysicalDevice getPhysDevice() const;
 
+    const VkPhysicalDeviceProperties &getPhysDeviceProps() const;
+
     const VkSurfaceFormatKHR &getSurfaceFormat() const;
 
-    VkSurfaceCapabilitiesKHR getSurfaceCaps();
+    // features the logical device was created with
+    const VkPhysicalDeviceFeatures &getEnabledFeatures() const {
+        return m_enabledFeatures;
+    }
+
+    // Queries the driver, call it only on swapchain creation or after a surface change
+    const SurfaceState &refreshSurfaceState();
+
+    const SurfaceState &getSurfaceState() const {
+        return m_surfaceState;
+    }
+
+    const VkSurfaceCapabilitiesKHR &getSurfaceCaps() const {
+        return m_surfaceState.caps;
+    }
 
     VkSurfaceKHR getSurface() const {
         return m_surface;
     }
 
+    // VK_KHR_timeline_semaphore is enabled on the device, see GpuTimeline
+    bool hasTimelineSemaphores() const {
+        return m_timelineSemaphores;
+    }
+
     int getQueueFamily() const {
         return m_gfxQueueFamily;
     }
 
+    // transfer-only family if the device has one, the graphics family otherwise
+    int getTransferQueueFamily() const {
+        return m_transferQueueFamily;
+    }
+
+    bool hasDedicatedTransferQueue() const {
+        return m_transferQueueFamily != m_gfxQueueFamily;
+    }
+
+    VkQueue getGraphicsQueue() const {
+        return m_gfxQueue;
+    }
+
+    VkQueue getTransferQueue() const {
+        return m_transferQueue;
+    }
+
+    // Queues are shared with the texture streaming thread, every access goes through these
+    VkResult queueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits,
+                         VkFence fence);
+
+    VkResult queuePresent(const VkPresentInfoKHR *presentInfo);
+
+    void waitIdle();
+
     VkInstance getInstance() const {
         return m_inst;
     }
@@ -42,12 +101,17 @@ public:
         return m_device;
     }
 
-    ANativeWindow *getWindow() const {
-        return m_winController.get();
+    bool isHeadless() const {
+        return m_headless;
     }
 
-    AAssetManager *getAssetManager() const {
-        return m_assetManager;
+    const Platform::AssetSource &getAssets() const {
+        assert(m_assets);
+        return *m_assets;
+    }
+
+    MemoryAllocator &getAllocator() {
+        return m_allocator;
     }
 
     void createSurface();
@@ -59,20 +123,28 @@ private:
 
     void createLogicalDevice();
 
-    void clean();
-
-    std::unique_ptr<ANativeWindow, ANativeWindowDeleter> m_winController = nullptr;
-    AAssetManager *m_assetManager = nullptr;
+    std::unique_ptr<Platform::SurfaceProvider> m_surfaceProvider = nullptr;
+    std::unique_ptr<Platform::AssetSource> m_assets = nullptr;
 
     // Vulkan stuff
     VkInstance m_inst = nullptr;
     VkSurfaceKHR m_surface = 0u;
+    SurfaceState m_surfaceState{};
     Utils::VulkanPhysicalDevices m_physDevices{};
     VkDevice m_device = nullptr;
+    VkPhysicalDeviceFeatures m_enabledFeatures{};
+    MemoryAllocator m_allocator;
 
     // Internal stuff
+    bool m_headless = false;
+    bool m_hasProperties2 = false; // VK_KHR_get_physical_device_properties2 on the instance
+    bool m_timelineSemaphores = false;
     int m_gfxDevIndex = -1;
     int m_gfxQueueFamily = -1;
+    int m_transferQueueFamily = -1;
+    VkQueue m_gfxQueue = nullptr;
+    VkQueue m_transferQueue = nullptr;
+    std::mutex m_queueMutex;
 };
 
 
@@ -1,47 +1,236 @@
+#include "CommandRecorder.h"
+#include "DeletionQueue.h"
+#include "GpuTimeline.h"
+#include "HsvComputePass.h"
+#include "HsvLut.h"
+#include "ParamChannel.h"
+#include "PipelineCache.h"
+#include "StagingPool.h"
+#include "TextureStreamer.h"
+#include "UniformRing.h"
 #include "VulkanCore.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
 #include <string_view>
 
 class VulkanRenderer {
-    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
-    static constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3; // capacity, see setFramesInFlight
+    static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+    static constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM; // decoded PNGs only
     static constexpr std::string_view TEXTURE_NAME = "texture.png";
+    static constexpr float MAX_ANISOTROPY = 16.0f;
+    static constexpr std::array<uint8_t, 4> PLACEHOLDER_PIXEL = {128u, 128u, 128u, 255u};
+    static constexpr VkFormat OFFSCREEN_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    static constexpr VkDeviceSize UNIFORM_RING_FRAME_SIZE = 64u * 1024u; // per frame in flight
 
     struct Texture {
         VkSampler sampler;
         VkImage image;
         VkImageLayout imageLayout;
-        VkDeviceMemory mem;
+        MemoryAllocator::Allocation mem;
         VkImageView view;
         int32_t width;
         int32_t height;
     };
 
+    // device-local color target used instead of a swapchain image in offscreen mode
+    struct OffscreenTarget {
+        VkImage image;
+        MemoryAllocator::Allocation mem;
+        VkImageView view;
+        VkFramebuffer framebuffer;
+    };
+
     struct UBO_Data {
         alignas(16) std::array<float, 16> MVP; // aligned as vec4 or 16bytes
     };
 
     struct PushConstant_Data {
         alignas(16) std::array<float, 3> HSV; // HSV factors for modifying
+        float filterMode; // 1 filters per fragment, 2 samples the compute pass output, 3 the LUT
+    };
+
+    // swapchain replaced by recreateSwapChain, destroyed once the frames using it are done
+    struct RetiredSwapchain {
+        VkSwapchainKHR swapchain;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkFramebuffer> framebuffers;
+    };
+
+    // everything a draw job needs, copied so workers never read state the frame changes
+    struct DrawState {
+        VkExtent2D extent;
+        VkDescriptorSet descriptorSet;
+        uint32_t uboOffset;
+        PushConstant_Data constants;
     };
 
 public:
-    void init(ANativeWindow *newWindow, AAssetManager *newManager);
+    struct FrameStats {
+        uint64_t rendered = 0u;
+        uint64_t skipped = 0u; // render() calls that found nothing to redraw
+    };
+
+    // CPU time of the frame phases summed over all frames. prepare runs before the frame
+    // wait, so with more frames in flight it hides behind the GPU instead of adding to wait
+    struct FrameTimings {
+        uint64_t frames = 0u;
+        double prepareMs = 0.0;
+        double waitMs = 0.0;    // on the timeline for the frame's previous submission
+        double acquireMs = 0.0; // swapchain only
+        double recordMs = 0.0;
+        double submitMs = 0.0;  // present included
+    };
+
+    // where the HSV adjustment of the right quad runs
+    enum class FilterPath {
+        Fragment, // per fragment on every frame
+        Compute,  // once per texel by HsvComputePass when the factors change
+        Lut       // one lookup per fragment into the lattice HsvLut bakes on factor changes
+    };
+
+    void init(std::unique_ptr<Platform::SurfaceProvider> surfaceProvider,
+              std::unique_ptr<Platform::AssetSource> assets);
+
+    // Renders into device-local color images instead of a swapchain, no window is needed
+    void initOffscreen(std::unique_ptr<Platform::AssetSource> assets,
+                       uint32_t width, uint32_t height);
 
+    // Submits a frame if needsRender(), otherwise only counts the call as skipped
     void render();
 
+    // A change of the factors, the filter path, the surface or a streamed texture landing
+    // needs a new frame; without one the last presented image stays valid
+    bool needsRender() const {
+        return m_continuous || m_surfaceChanged || m_hsvChannel.hasUpdate() ||
+               m_redrawRequested.load(std::memory_order_acquire);
+    }
+
+    // Thread safe, schedules a frame and calls the wake callback
+    void requestRender();
+
+    // Lets a render loop blocked on its event queue wake up when requestRender is called from
+    // another thread, e.g. ALooper_wake. Has to be set before init
+    void setWakeCallback(std::function<void()> wake) {
+        m_wake = std::move(wake);
+    }
+
+    // every render() call submits a frame, meant for benchmarks
+    void setContinuous(bool continuous) {
+        m_continuous = continuous;
+    }
+
+    FrameStats getFrameStats() const {
+        return m_frameStats;
+    }
+
+    FrameTimings getFrameTimings() const {
+        return m_frameTimings;
+    }
+
+    struct SwapchainStats {
+        uint32_t recreations = 0u;
+        double totalStallMs = 0.0; // render thread time spent in recreateSwapChain
+        double maxStallMs = 0.0;
+    };
+
+    DeletionQueue::Stats getDeletionStats() const {
+        return m_deletionQueue.getStats();
+    }
+
+    // Streams a texture that replaces the current one once its upload landed, the old image
+    // is destroyed after the frames sampling it are done
+    void requestTexture(std::string path);
+
+    SwapchainStats getSwapchainStats() const {
+        return m_swapchainStats;
+    }
+
+    // Benchmarks swapchain recreation by forcing one every frames submitted frames, 0 only
+    // recreates when the surface changes
+    void setRecreateInterval(uint32_t frames) {
+        m_recreateInterval = frames;
+    }
+
+    // Frames the CPU may record ahead of the GPU, 1 for the lowest latency up to
+    // MAX_FRAMES_IN_FLIGHT for throughput. Takes effect on the next init
+    void setFramesInFlight(uint32_t count) {
+        m_requestedFramesInFlight = std::clamp(count, 1u, MAX_FRAMES_IN_FLIGHT);
+    }
+
+    // Copies the last rendered offscreen frame into tightly packed RGBA8 pixels
+    void readOffscreenImage(std::vector<uint8_t> &pixels);
+
+    // Where the pipeline cache is persisted, takes effect on the next init
+    void setPipelineCachePath(std::string path) {
+        m_pipelineCachePath = std::move(path);
+    }
+
+    // Worker threads recording the draws into secondary command buffers, 0 records them
+    // inline on the render thread. Takes effect on the next init
+    void setRecordingThreads(uint32_t threadCount) {
+        m_recordingThreads = threadCount;
+    }
+
+    // Streams name.astc/etc2/bc.ktx2 variants of textures when present instead of decoding
+    // the PNG, see TextureStreamer. Off by default, takes effect on the next init
+    void setCompressedTextures(bool enabled) {
+        m_compressedTextures = enabled;
+    }
+
+    // recording time per thread, see CommandRecorder
+    std::vector<CommandRecorder::ThreadStats> getRecordingStats() const {
+        return m_recorder.getThreadStats();
+    }
+
+    bool isOffscreen() const {
+        return m_offscreen;
+    }
+
     void cleanup();
 
     void cleanupSwapChain();
 
+    // Window resized or rotated, the next frame recreates the swapchain if the surface
+    // transform or size really changed
+    void onSurfaceChanged() {
+        m_surfaceChanged = true;
+    }
+
+    // Called from one thread at a time, e.g. the JNI caller; never blocks. The render thread
+    // takes the latest values at the start of its next frame
     void setHSVFactors(float hue, float saturation, float intensity) {
-        m_hsvFactors.HSV[0] = std::clamp(hue, 0.0f, 1.0f);;
-        m_hsvFactors.HSV[1] = std::clamp(saturation, 0.0f, 1.0f);;
-        m_hsvFactors.HSV[2] = std::clamp(intensity, 0.0f, 1.0f);;
+        m_hsvChannel.publish({std::clamp(hue, 0.0f, 1.0f), std::clamp(saturation, 0.0f, 1.0f),
+                              std::clamp(intensity, 0.0f, 1.0f)});
+        if (m_wake) {
+            m_wake();
+        }
+    }
+
+    // takes effect with the next frame, Compute falls back to Fragment if unsupported or the
+    // build lacks HSV_COMPUTE_FILTER
+    void setFilterPath(FilterPath path) {
+        if (path != m_filterPath) {
+            m_filterPath = path;
+            requestRender();
+        }
+    }
+
+    FilterPath getFilterPath() const {
+        if (m_filterPath == FilterPath::Compute && !m_hsvCompute.isReady()) {
+            return FilterPath::Fragment;
+        }
+        return m_filterPath;
     }
 
 private:
-    void createSwapChain();
+    // oldSwapchain is handed over to the new one, it stays owned by the caller
+    void createSwapChain(VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 
     void createImageViews();
 
@@ -49,23 +238,63 @@ private:
 
     void createDescriptorSetLayout();
 
+    void createPipelineCache();
+
     void createGraphicsPipeline();
 
+    void createHsvComputePass();
+
+    // leaves the compute output and the LUT in SHADER_READ_ONLY_OPTIMAL, baked for the
+    // initial factors
+    void initFilterImages();
+
     void createFramebuffers();
 
+    void createOffscreenTargets();
+
+    void cleanupOffscreenTargets();
+
+    // the part of render() after the frame wait
+    void renderOffscreen(std::chrono::steady_clock::time_point waited);
+
+    VkFormat getColorFormat() const;
+
+    VkExtent2D getRenderExtent() const;
+
     void createCommandPool();
 
     void createCommandBuffer();
 
     void createSyncObjects();
 
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer);
+
+    // called on recording threads, only reads state that is fixed while a frame is recorded
+    void recordQuad(VkCommandBuffer commandBuffer, const DrawState &state,
+                    uint32_t firstVertex) const;
 
     void recreateSwapChain();
 
+    // queries the surface, true if its transform or size differ from the swapchain's
+    bool isSwapchainOutdated();
+
+    // destroys the object through deleter once the graphics timeline passed the submission
+    // being prepared, the only retirement path of the renderer and its passes
+    void deferDestroy(std::function<void()> deleter);
+
+    // deferDestroy for components releasing their own objects
+    DeletionQueue::Defer getDeferDestroy() {
+        return [this](std::function<void()> deleter) { deferDestroy(std::move(deleter)); };
+    }
+
+    // runs the deletions no frame in flight depends on anymore, call after the frame wait
+    void collectDeletions();
+
+    void destroySwapchain(RetiredSwapchain &swapchain);
+
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                       VkMemoryPropertyFlags properties, VkBuffer &buffer,
-                      VkDeviceMemory &bufferMemory);
+                      MemoryAllocator::Allocation &bufferMemory);
 
     void createUniformBuffers();
 
@@ -75,12 +304,34 @@ private:
 
     void createDescriptorSets();
 
-    void loadTextureFromFile(const char *filePath,
-                             Texture *texture,
-                             VkImageUsageFlags usage, VkFlags required_props);
+    // synchronous upload on the graphics queue, meant for small images only
+    void createTextureFromPixels(const uint8_t *pixels, uint32_t width, uint32_t height,
+                                 Texture *texture);
+
+    // records into a temporary command buffer and waits for its submission on the graphics
+    // timeline
+    void submitOneTimeCommands(const std::function<void(VkCommandBuffer)> &record);
+
+    void destroyTexture(Texture &texture);
 
     void createTexture();
 
+    // CPU side state of the next frame: finished uploads, filter path and uniform data.
+    // Touches nothing a frame in flight may still read, so it runs before the frame wait
+    void prepareFrame();
+
+    // descriptor and semaphore updates for the uploads, call right after the frame wait
+    void integrateStreamedTextures();
+
+    // semaphores of newly integrated uploads the frame submission has to wait for
+    void takeUploadWaits(std::vector<VkSemaphore> &semaphores,
+                         std::vector<VkPipelineStageFlags> &stages);
+
+    void writeTextureDescriptor(uint32_t frame);
+
+    // snapshot of the factors published by setHSVFactors, schedules a frame if they changed
+    void takeHSVFactors();
+
 private:
     VulkanCore m_core;
     bool m_initialized{false};
@@ -88,28 +339,66 @@ private:
     std::vector<VkImage> m_swapChainImages{};
     std::vector<VkImageView> m_swapChainImageViews{};
     std::vector<VkFramebuffer> m_swapChainFramebuffers{};
+    SwapchainStats m_swapchainStats{};
+    uint32_t m_recreateInterval{0u};
     VkCommandPool m_commandPool{0u};
     std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> m_commandBuffers{};
-
-    PushConstant_Data m_hsvFactors{0.5f, 0.5f, 0.5f};
-    Texture m_texture;
+    CommandRecorder m_recorder;
+    uint32_t m_recordingThreads{0u};
+    bool m_compressedTextures{false};
+
+    StagingPool m_stagingPool;
+
+    PushConstant_Data m_hsvFactors{{0.5f, 0.5f, 0.5f}, 1.0f}; // render thread only
+    FilterPath m_frameFilterPath{FilterPath::Fragment}; // of the frame being prepared
+    UBO_Data m_preparedUbo{};
+    ParamChannel<std::array<float, 3>> m_hsvChannel{{0.5f, 0.5f, 0.5f}};
+    FilterPath m_filterPath{FilterPath::Fragment};
+    HsvComputePass m_hsvCompute;
+    HsvLut m_hsvLut;
+    Texture m_texture{};
+    Texture m_placeholder{};
+    TextureStreamer m_streamer;
+    std::vector<TextureStreamer::Result> m_pendingUploads{};
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> m_descriptorDirty{};
     VkQueue m_queue{nullptr};
+    GpuTimeline m_gfxTimeline; // every submission to m_queue goes through it
 
     VkRenderPass m_renderPass{0u};
     VkDescriptorSetLayout m_descriptorSetLayout{0u};
     VkPipelineLayout m_pipelineLayout{0u};
     VkPipeline m_graphicsPipeline{0u};
+    PipelineCache m_pipelineCache;
+    std::string m_pipelineCachePath{};
 
-    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_uniformBuffers{};
-    std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> m_uniformBuffersMemory{};
+    UniformRing m_uniformRing;
+    uint32_t m_uboOffset{0u}; // dynamic offset of the current frame's UBO_Data
 
     std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_imageAvailableSemaphores{};
     std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_renderFinishedSemaphores{};
-    std::array<VkFence, MAX_FRAMES_IN_FLIGHT> m_inFlightFences{};
+    // graphics timeline value of each frame's last submission, waited on before reuse
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_frameValues{};
     VkDescriptorPool m_descriptorPool{0u};
     std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_descriptorSets{};
 
+    bool m_offscreen{false};
+    VkExtent2D m_offscreenExtent{};
+    std::array<OffscreenTarget, MAX_FRAMES_IN_FLIGHT> m_offscreenTargets{};
+    uint32_t m_lastOffscreenFrame{0u};
+
     uint32_t m_currentFrame{0u};
-    bool m_orientationChanged{false};
+    uint64_t m_frameSerial{0u}; // frames submitted since init, paces m_recreateInterval
+    DeletionQueue m_deletionQueue;
+    uint32_t m_framesInFlight{DEFAULT_FRAMES_IN_FLIGHT};
+    uint32_t m_requestedFramesInFlight{DEFAULT_FRAMES_IN_FLIGHT};
+    bool m_surfaceChanged{false};
+    std::atomic<bool> m_redrawRequested{true};
+    bool m_continuous{false};
+    std::function<void()> m_wake{};
+    FrameStats m_frameStats{};
+    FrameTimings m_frameTimings{};
+    // of the current swapchain, the surface may have moved on already
     VkSurfaceTransformFlagBitsKHR m_pretransformFlag;
+    VkExtent2D m_swapchainExtent{}; // identity orientation
+    std::array<float, 16> m_swapchainPreRotation{};
 };
@@ -4,18 +4,32 @@
 
 #include "VulkanRenderer.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <chrono>
+#include <cstring>
 
 using namespace Utils;
 
-void VulkanRenderer::init(ANativeWindow *newWindow, AAssetManager *newManager) {
-    assert(newWindow && newManager);
-    m_core.init(newWindow, newManager);
+static double millisecondsBetween(std::chrono::steady_clock::time_point from,
+                                  std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+void VulkanRenderer::init(std::unique_ptr<Platform::SurfaceProvider> surfaceProvider,
+                          std::unique_ptr<Platform::AssetSource> assets) {
+    assert(surfaceProvider && assets);
     if (m_initialized) {
         cleanup();
     }
-    vkGetDeviceQueue(m_core.getDevice(), m_core.getQueueFamily(), 0, &m_queue);
+    m_offscreen = false;
+    m_surfaceChanged = false;
+    m_framesInFlight = m_requestedFramesInFlight;
+    m_currentFrame = 0u;
+    m_frameSerial = 0u;
+    m_core.init(std::move(surfaceProvider), std::move(assets));
+    m_queue = m_core.getGraphicsQueue();
+    m_gfxTimeline.init(m_core, m_queue);
+    m_stagingPool.init(m_core.getDevice(), m_core.getAllocator());
+    m_hsvLut.init(m_core, m_stagingPool, getDeferDestroy());
     createSwapChain();
     createImageViews();
     createRenderPass();
@@ -24,127 +38,147 @@ void VulkanRenderer::init(ANativeWindow *newWindow, AAssetManager *newManager) {
     createDescriptorPool();
     createTexture();
     createDescriptorSets();
+    createPipelineCache();
     createGraphicsPipeline();
+    createHsvComputePass();
+    initFilterImages();
     createFramebuffers();
     createCommandPool();
     createCommandBuffer();
+    m_recorder.init(m_core, m_framesInFlight, m_recordingThreads);
     createSyncObjects();
+    m_core.getAllocator().logStats();
+    m_redrawRequested.store(true, std::memory_order_release);
     m_initialized = true;
 }
 
-void VulkanRenderer::loadTextureFromFile(const char* filePath,
-                                             Texture* texture,
-                                             VkImageUsageFlags usage, VkFlags required_props) {
-    // Check for linear supportability
-    VkFormatProperties props;
-    bool needBlit = true;
-
-    auto vkGetPhysicalDeviceFormatProperties =
-            reinterpret_cast<PFN_vkGetPhysicalDeviceFormatProperties>(
-                    vkGetInstanceProcAddr(m_core.getInstance(),
-                                          "vkGetPhysicalDeviceFormatProperties"));
-    assert(vkGetPhysicalDeviceFormatProperties);
-
-    vkGetPhysicalDeviceFormatProperties(m_core.getPhysDevice(), TEXTURE_FORMAT, &props);
-    assert((props.linearTilingFeatures | props.optimalTilingFeatures) &
-           VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
-
-    if (props.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-        // linear format supporting the required texture
-        needBlit = false;
+void VulkanRenderer::initOffscreen(std::unique_ptr<Platform::AssetSource> assets,
+                                   uint32_t width, uint32_t height) {
+    assert(assets && width > 0u && height > 0u);
+    if (m_initialized) {
+        cleanup();
     }
+    m_offscreen = true;
+    m_offscreenExtent = {width, height};
+    m_framesInFlight = m_requestedFramesInFlight;
+    m_frameSerial = 0u;
+    m_pretransformFlag = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    m_core.initHeadless(std::move(assets));
+    m_queue = m_core.getGraphicsQueue();
+    m_gfxTimeline.init(m_core, m_queue);
+    m_stagingPool.init(m_core.getDevice(), m_core.getAllocator());
+    m_hsvLut.init(m_core, m_stagingPool, getDeferDestroy());
+    createRenderPass();
+    createDescriptorSetLayout();
+    createUniformBuffers();
+    createDescriptorPool();
+    createTexture();
+    createDescriptorSets();
+    createPipelineCache();
+    createGraphicsPipeline();
+    createHsvComputePass();
+    initFilterImages();
+    createOffscreenTargets();
+    createCommandPool();
+    createCommandBuffer();
+    m_recorder.init(m_core, m_framesInFlight, m_recordingThreads);
+    createSyncObjects();
+    // there is no user to look at the placeholder, let the first frame show the texture
+    m_streamer.waitIdle();
+    m_core.getAllocator().logStats();
+    m_currentFrame = 0u;
+    m_redrawRequested.store(true, std::memory_order_release);
+    m_initialized = true;
+}
 
-    // Read the file:
-    AAsset* file = AAssetManager_open(m_core.getAssetManager(),
-                                      filePath, AASSET_MODE_BUFFER);
-    size_t fileLength = AAsset_getLength(file);
-    stbi_uc* fileContent = new unsigned char[fileLength];
-    AAsset_read(file, fileContent, fileLength);
-    AAsset_close(file);
+void VulkanRenderer::createTextureFromPixels(const uint8_t* pixels, uint32_t width,
+                                             uint32_t height, Texture* texture) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(m_core.getPhysDevice(), TEXTURE_FORMAT, &props);
+    assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
-    int imgWidth, imgHeight, n;
-    unsigned char* imageData = stbi_load_from_memory (
-            fileContent, fileLength, &imgWidth,
-            &imgHeight, &n, 4);
-    assert(n == 4);
+    texture->width = static_cast<int32_t>(width);
+    texture->height = static_cast<int32_t>(height);
 
-    texture->width = imgWidth;
-    texture->height = imgHeight;
+    // Pixels go to a staging buffer with tightly packed rows
+    const VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * 4u;
+    StagingPool::Buffer staging = m_stagingPool.acquire(imageSize);
+    memcpy(staging.data(), pixels, imageSize);
 
-    // Allocate the linear texture so texture could be copied over
     VkImageCreateInfo image_create_info = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .pNext = nullptr,
             .flags = 0,
             .imageType = VK_IMAGE_TYPE_2D,
             .format = TEXTURE_FORMAT,
-            .extent = {static_cast<uint32_t>(imgWidth),
-                       static_cast<uint32_t>(imgHeight), 1},
+            .extent = {width, height, 1},
             .mipLevels = 1,
             .arrayLayers = 1,
             .samples = VK_SAMPLE_COUNT_1_BIT,
-            .tiling = VK_IMAGE_TILING_LINEAR,
-            .usage = (needBlit ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT
-                               : VK_IMAGE_USAGE_SAMPLED_BIT),
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            //.queueFamilyIndexCount = 1,
-            //.pQueueFamilyIndices = {m_core.getQueueFamily()},
-            .initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices = nullptr,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
     };
-    VkMemoryAllocateInfo mem_alloc = {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext = nullptr,
-            .allocationSize = 0,
-            .memoryTypeIndex = 0,
-    };
-
-    VkMemoryRequirements mem_reqs;
     VK_CHECK(vkCreateImage(m_core.getDevice(), &image_create_info, nullptr,
                           &texture->image));
-    vkGetImageMemoryRequirements(m_core.getDevice(), texture->image, &mem_reqs);
-    mem_alloc.allocationSize = mem_reqs.size;
-    VK_CHECK(allocateMemoryTypeFromProperties(m_core.getPhysDevice(), mem_reqs.memoryTypeBits,
-                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                              &mem_alloc.memoryTypeIndex));
-    VK_CHECK(vkAllocateMemory(m_core.getDevice(), &mem_alloc, nullptr, &texture->mem));
-    VK_CHECK(vkBindImageMemory(m_core.getDevice(), texture->image, texture->mem, 0));
-
-    if (required_props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-        const VkImageSubresource subres = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .arrayLayer = 0,
-        };
-        VkSubresourceLayout layout;
-        void* data;
-
-        vkGetImageSubresourceLayout(m_core.getDevice(), texture->image, &subres,
-                                    &layout);
-        VK_CHECK(vkMapMemory(m_core.getDevice(), texture->mem, 0,
-                            mem_alloc.allocationSize, 0, &data));
-
-        for (int32_t y = 0; y < imgHeight; y++) {
-            unsigned char* row = (unsigned char*)((char*)data + layout.rowPitch * y);
-            for (int32_t x = 0; x < imgWidth; x++) {
-                row[x * 4] = imageData[(x + y * imgWidth) * 4];
-                row[x * 4 + 1] = imageData[(x + y * imgWidth) * 4 + 1];
-                row[x * 4 + 2] = imageData[(x + y * imgWidth) * 4 + 2];
-                row[x * 4 + 3] = imageData[(x + y * imgWidth) * 4 + 3];
-            }
-        }
+    texture->mem = m_core.getAllocator().allocateForImage(texture->image,
+                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                          VK_IMAGE_TILING_OPTIMAL);
+    texture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        vkUnmapMemory(m_core.getDevice(), texture->mem);
-        stbi_image_free(imageData);
-    }
-    delete[] fileContent;
+    VkImageViewCreateInfo view = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .image = texture->image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = TEXTURE_FORMAT,
+            .components =
+                    {
+                            VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G,
+                            VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A,
+                    },
+            .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+    };
+    VK_CHECK(vkCreateImageView(m_core.getDevice(), &view, nullptr, &texture->view));
 
-    texture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    submitOneTimeCommands([&](VkCommandBuffer gfxCmd) {
+        setImageLayout(gfxCmd, texture->image, VK_IMAGE_LAYOUT_UNDEFINED,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        VkBufferImageCopy copyRegion{
+                .bufferOffset = 0,
+                .bufferRowLength = 0, // tightly packed
+                .bufferImageHeight = 0,
+                .imageSubresource {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = 0,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                },
+                .imageOffset { .x = 0, .y = 0, .z = 0 },
+                .imageExtent { .width = width, .height = height, .depth = 1,},
+        };
+        vkCmdCopyBufferToImage(gfxCmd, staging.buffer, texture->image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        setImageLayout(gfxCmd, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       SHADER_READ_STAGES);
+    });
+    m_stagingPool.release(staging);
+}
 
+void VulkanRenderer::submitOneTimeCommands(const std::function<void(VkCommandBuffer)> &record) {
     VkCommandPoolCreateInfo cmdPoolCreateInfo{
             .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
             .pNext = nullptr,
             .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
             .queueFamilyIndex = static_cast<uint32_t>(m_core.getQueueFamily()),
     };
-
     VkCommandPool cmdPool;
     VK_CHECK(vkCreateCommandPool(m_core.getDevice(), &cmdPoolCreateInfo, nullptr,
                                 &cmdPool));
@@ -162,84 +196,11 @@ void VulkanRenderer::loadTextureFromFile(const char* filePath,
     VkCommandBufferBeginInfo cmd_buf_info = {
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
             .pNext = nullptr,
-            .flags = 0,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
             .pInheritanceInfo = nullptr};
     VK_CHECK(vkBeginCommandBuffer(gfxCmd, &cmd_buf_info));
-
-    // If linear is supported, we are done
-    VkImage stageImage = VK_NULL_HANDLE;
-    VkDeviceMemory stageMem = VK_NULL_HANDLE;
-    if (!needBlit) {
-        setImageLayout(gfxCmd, texture->image, VK_IMAGE_LAYOUT_PREINITIALIZED,
-                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                       VK_PIPELINE_STAGE_HOST_BIT,
-                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-    } else {
-        // save current image and mem as staging image and memory
-        stageImage = texture->image;
-        stageMem = texture->mem;
-        texture->image = VK_NULL_HANDLE;
-        texture->mem = VK_NULL_HANDLE;
-
-        // Create a tile texture to blit into
-        image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-        image_create_info.usage =
-                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        VK_CHECK(vkCreateImage(m_core.getDevice(), &image_create_info, nullptr,
-                              &texture->image));
-        vkGetImageMemoryRequirements(m_core.getDevice(), texture->image, &mem_reqs);
-
-        mem_alloc.allocationSize = mem_reqs.size;
-        VK_CHECK(allocateMemoryTypeFromProperties(
-                m_core.getPhysDevice(), mem_reqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                &mem_alloc.memoryTypeIndex));
-        VK_CHECK(
-                vkAllocateMemory(m_core.getDevice(), &mem_alloc, nullptr, &texture->mem));
-        VK_CHECK(vkBindImageMemory(m_core.getDevice(), texture->image, texture->mem, 0));
-
-        // transitions image out of UNDEFINED type
-        setImageLayout(gfxCmd, stageImage, VK_IMAGE_LAYOUT_PREINITIALIZED,
-                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-        setImageLayout(gfxCmd, texture->image, VK_IMAGE_LAYOUT_UNDEFINED,
-                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-        VkImageCopy bltInfo{
-                .srcSubresource {
-                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                        .mipLevel = 0,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1,
-                },
-                .srcOffset { .x = 0, .y = 0, .z = 0 },
-                .dstSubresource {
-                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                        .mipLevel = 0,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1,
-                },
-                .dstOffset { .x = 0, .y = 0, .z = 0},
-                .extent { .width = static_cast<uint32_t>(imgWidth), .height = static_cast<uint32_t>(imgHeight), .depth = 1,},
-        };
-        vkCmdCopyImage(gfxCmd, stageImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                       &bltInfo);
-
-        setImageLayout(gfxCmd, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                       VK_PIPELINE_STAGE_TRANSFER_BIT,
-                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-    }
-
+    record(gfxCmd);
     VK_CHECK(vkEndCommandBuffer(gfxCmd));
-    VkFenceCreateInfo fenceInfo = {
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = 0,
-    };
-    VkFence fence;
-    VK_CHECK(vkCreateFence(m_core.getDevice(), &fenceInfo, nullptr, &fence));
 
     VkSubmitInfo submitInfo = {
             .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -252,65 +213,137 @@ void VulkanRenderer::loadTextureFromFile(const char* filePath,
             .signalSemaphoreCount = 0,
             .pSignalSemaphores = nullptr,
     };
-    VK_CHECK(vkQueueSubmit(m_queue, 1u, &submitInfo, fence) != VK_SUCCESS);
-    VK_CHECK(vkWaitForFences(m_core.getDevice(), 1, &fence, VK_TRUE, 100000000) !=
-            VK_SUCCESS);
-    vkDestroyFence(m_core.getDevice(), fence, nullptr);
+    m_gfxTimeline.wait(m_gfxTimeline.submit(submitInfo));
 
     vkFreeCommandBuffers(m_core.getDevice(), cmdPool, 1, &gfxCmd);
     vkDestroyCommandPool(m_core.getDevice(), cmdPool, nullptr);
-    if (stageImage != VK_NULL_HANDLE) {
-        vkDestroyImage(m_core.getDevice(), stageImage, nullptr);
-        vkFreeMemory(m_core.getDevice(), stageMem, nullptr);
-    }
+}
+
+void VulkanRenderer::destroyTexture(Texture &texture) {
+    vkDestroyImageView(m_core.getDevice(), texture.view, nullptr);
+    vkDestroyImage(m_core.getDevice(), texture.image, nullptr);
+    m_core.getAllocator().free(texture.mem);
+    texture.view = VK_NULL_HANDLE;
+    texture.image = VK_NULL_HANDLE;
 }
 
 void VulkanRenderer::createTexture() {
-        loadTextureFromFile(TEXTURE_NAME.data(), &m_texture, VK_IMAGE_USAGE_SAMPLED_BIT,
-                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-        const VkSamplerCreateInfo sampler = {
-                .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-                .pNext = nullptr,
-                .magFilter = VK_FILTER_NEAREST,
-                .minFilter = VK_FILTER_NEAREST,
-                .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
-                .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-                .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-                .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-                .mipLodBias = 0.0f,
-                .maxAnisotropy = 1,
-                .compareOp = VK_COMPARE_OP_NEVER,
-                .minLod = 0.0f,
-                .maxLod = 0.0f,
-                .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
-                .unnormalizedCoordinates = VK_FALSE,
-        };
-        VkImageViewCreateInfo view = {
-                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                .pNext = nullptr,
-                .flags = 0,
-                .image = VK_NULL_HANDLE,
-                .viewType = VK_IMAGE_VIEW_TYPE_2D,
-                .format = TEXTURE_FORMAT,
-                .components =
-                        {
-                                VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G,
-                                VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A,
-                        },
-                .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
-        };
+    // trilinear, anisotropic when the device was created with it
+    const bool anisotropy = m_core.getEnabledFeatures().samplerAnisotropy == VK_TRUE;
+    const float maxAnisotropy =
+            anisotropy ? std::min(MAX_ANISOTROPY,
+                                  m_core.getPhysDeviceProps().limits.maxSamplerAnisotropy)
+                       : 1.0f;
+    const VkSamplerCreateInfo sampler = {
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .magFilter = VK_FILTER_LINEAR,
+            .minFilter = VK_FILTER_LINEAR,
+            .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+            .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            .mipLodBias = 0.0f,
+            .anisotropyEnable = anisotropy ? VK_TRUE : VK_FALSE,
+            .maxAnisotropy = maxAnisotropy,
+            .compareEnable = VK_FALSE,
+            .compareOp = VK_COMPARE_OP_NEVER,
+            .minLod = 0.0f,
+            .maxLod = VK_LOD_CLAMP_NONE,
+            .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+            .unnormalizedCoordinates = VK_FALSE,
+    };
+
+    VK_CHECK(vkCreateSampler(m_core.getDevice(), &sampler, nullptr, &m_texture.sampler));
+
+    // shown until the streamed texture lands
+    createTextureFromPixels(PLACEHOLDER_PIXEL.data(), 1u, 1u, &m_placeholder);
+
+    // the placeholder stays on screen until the next frame, which needs a wake up when idle
+    m_streamer.setCompletionCallback([this]() { requestRender(); });
+    m_streamer.setCompressedVariants(m_compressedTextures);
+    m_streamer.init(m_core, m_stagingPool, TEXTURE_FORMAT);
+    m_streamer.request(std::string(TEXTURE_NAME));
+}
 
-    VK_CHECK(vkCreateSampler(m_core.getDevice(), &sampler, nullptr,
-                                &m_texture.sampler));
-        view.image = m_texture.image;
-    VK_CHECK(
-                vkCreateImageView(m_core.getDevice(), &view, nullptr, &m_texture.view));
+void VulkanRenderer::requestTexture(std::string path) {
+    assert(m_initialized);
+    m_streamer.request(std::move(path));
+}
+
+void VulkanRenderer::prepareFrame() {
+    // only handles are taken over here, descriptors are rewritten after the frame wait
+    for (auto &result: m_streamer.takeCompleted()) {
+        if (m_texture.image != VK_NULL_HANDLE) {
+            // a texture swap, frames in flight may still sample the old image
+            deferDestroy([this, texture = m_texture]() mutable { destroyTexture(texture); });
+        }
+        m_texture.image = result.image;
+        m_texture.mem = result.mem;
+        m_texture.view = result.view;
+        m_texture.width = result.width;
+        m_texture.height = result.height;
+        m_texture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_pendingUploads.push_back(result);
+        // sets of frames still in flight are rewritten once their own submission completed
+        m_descriptorDirty.fill(true);
+    }
+
+    m_frameFilterPath = getFilterPath();
+    switch (m_frameFilterPath) {
+        case FilterPath::Fragment:
+            m_hsvFactors.filterMode = 1.0f;
+            break;
+        case FilterPath::Compute:
+            m_hsvFactors.filterMode = 2.0f;
+            break;
+        case FilterPath::Lut:
+            m_hsvFactors.filterMode = 3.0f;
+            break;
+    }
+
+    if (m_offscreen) {
+        // nothing is presented, so there is no display rotation to compensate
+        getPrerotationMatrix({}, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, m_preparedUbo.MVP);
+    } else {
+        // precomputed on swapchain creation, no surface query per frame
+        m_preparedUbo.MVP = m_swapchainPreRotation;
+    }
+}
+
+void VulkanRenderer::integrateStreamedTextures() {
+    // the compute output follows the texture, a new image means new descriptors
+    if (m_frameFilterPath == FilterPath::Compute) {
+        const Texture &source = m_texture.view != VK_NULL_HANDLE ? m_texture : m_placeholder;
+        if (m_hsvCompute.setSource(source.view, m_texture.sampler, source.width,
+                                   source.height)) {
+            m_descriptorDirty.fill(true);
+        }
+    }
+
+    if (m_descriptorDirty[m_currentFrame]) {
+        writeTextureDescriptor(m_currentFrame);
+        m_descriptorDirty[m_currentFrame] = false;
+    }
+}
+
+void VulkanRenderer::takeUploadWaits(std::vector<VkSemaphore> &semaphores,
+                                     std::vector<VkPipelineStageFlags> &stages) {
+    for (const auto &upload: m_pendingUploads) {
+        semaphores.push_back(upload.ready);
+        stages.push_back(TextureStreamer::WAIT_STAGE);
+        // waited on by this frame's submission
+        deferDestroy([this, semaphore = upload.ready]() {
+            vkDestroySemaphore(m_core.getDevice(), semaphore, nullptr);
+        });
+    }
+    m_pendingUploads.clear();
 }
 
 void VulkanRenderer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                                   VkMemoryPropertyFlags properties, VkBuffer &buffer,
-                                  VkDeviceMemory &bufferMemory) {
+                                  MemoryAllocator::Allocation &bufferMemory) {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
@@ -319,35 +352,20 @@ void VulkanRenderer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
 
     VK_CHECK(vkCreateBuffer(m_core.getDevice(), &bufferInfo, nullptr, &buffer));
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(m_core.getDevice(), buffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex =
-            findMemoryType(m_core.getPhysDevice(), memRequirements.memoryTypeBits, properties);
-
-    VK_CHECK(vkAllocateMemory(m_core.getDevice(), &allocInfo, nullptr, &bufferMemory));
-
-    vkBindBufferMemory(m_core.getDevice(), buffer, bufferMemory, 0);
+    bufferMemory = m_core.getAllocator().allocateForBuffer(buffer, properties);
 }
 
 void VulkanRenderer::createUniformBuffers() {
-    VkDeviceSize bufferSize = sizeof(UBO_Data);
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     m_uniformBuffers[i], m_uniformBuffersMemory[i]);
-    }
+    static_assert(sizeof(UBO_Data) <= UNIFORM_RING_FRAME_SIZE);
+    m_uniformRing.init(m_core.getDevice(), m_core.getAllocator(),
+                       m_core.getPhysDeviceProps().limits.minUniformBufferOffsetAlignment,
+                       UNIFORM_RING_FRAME_SIZE, m_framesInFlight);
 }
 
 void VulkanRenderer::createDescriptorSetLayout() {
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount = 1;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     uboLayoutBinding.pImmutableSamplers = nullptr;
@@ -359,7 +377,15 @@ void VulkanRenderer::createDescriptorSetLayout() {
     samplerLayoutBinding.pImmutableSamplers = nullptr;
     samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings = {uboLayoutBinding, samplerLayoutBinding};
+    VkDescriptorSetLayoutBinding filteredLayoutBinding = samplerLayoutBinding;
+    filteredLayoutBinding.binding = 2;
+
+    VkDescriptorSetLayoutBinding lutLayoutBinding = samplerLayoutBinding;
+    lutLayoutBinding.binding = 3;
+
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings = {uboLayoutBinding, samplerLayoutBinding,
+                                                            filteredLayoutBinding,
+                                                            lutLayoutBinding};
 
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -371,57 +397,148 @@ void VulkanRenderer::createDescriptorSetLayout() {
 }
 
 void VulkanRenderer::recreateSwapChain() {
-    vkDeviceWaitIdle(m_core.getDevice());
-    cleanupSwapChain();
-    createSwapChain();
+    const auto start = std::chrono::steady_clock::now();
+    // no GPU drain: frames in flight keep presenting from the old swapchain, which is handed
+    // to the new one and destroyed with its views and framebuffers once they are done
+    RetiredSwapchain retired{m_swapChain, std::move(m_swapChainImageViews),
+                             std::move(m_swapChainFramebuffers)};
+    createSwapChain(retired.swapchain);
     createImageViews();
     createFramebuffers();
+    deferDestroy([this, retired]() mutable { destroySwapchain(retired); });
+
+    const double stallMs = millisecondsBetween(start, std::chrono::steady_clock::now());
+    ++m_swapchainStats.recreations;
+    m_swapchainStats.totalStallMs += stallMs;
+    m_swapchainStats.maxStallMs = std::max(m_swapchainStats.maxStallMs, stallMs);
+    LOGI("Swapchain recreated in %.2f ms, %zu deletions pending", stallMs,
+         m_deletionQueue.getStats().pending);
+}
+
+bool VulkanRenderer::isSwapchainOutdated() {
+    // config changes such as locale or night mode and repeated suboptimal presents keep the
+    // surface as it is, only a new transform or size is worth a swapchain
+    const VulkanCore::SurfaceState &surface = m_core.refreshSurfaceState();
+    return surface.transform != m_pretransformFlag ||
+           surface.caps.currentExtent.width != m_swapchainExtent.width ||
+           surface.caps.currentExtent.height != m_swapchainExtent.height;
+}
+
+void VulkanRenderer::deferDestroy(std::function<void()> deleter) {
+    // keyed with the next graphics submission, the frame being prepared, which may reference
+    // the object until it is submitted
+    m_deletionQueue.push(m_gfxTimeline.getSubmittedValue() + 1u, std::move(deleter));
+}
+
+void VulkanRenderer::collectDeletions() {
+    // frames, uploads and readbacks share the timeline, whatever completed frees its objects
+    m_deletionQueue.collect(m_gfxTimeline.getCompletedValue());
+}
+
+void VulkanRenderer::destroySwapchain(RetiredSwapchain &swapchain) {
+    for (VkFramebuffer framebuffer: swapchain.framebuffers) {
+        vkDestroyFramebuffer(m_core.getDevice(), framebuffer, nullptr);
+    }
+    for (VkImageView view: swapchain.imageViews) {
+        vkDestroyImageView(m_core.getDevice(), view, nullptr);
+    }
+    vkDestroySwapchainKHR(m_core.getDevice(), swapchain.swapchain, nullptr);
+    swapchain = {};
+}
+
+void VulkanRenderer::requestRender() {
+    m_redrawRequested.store(true, std::memory_order_release);
+    if (m_wake) {
+        m_wake();
+    }
+}
+
+void VulkanRenderer::takeHSVFactors() {
+    std::array<float, 3> factors{};
+    if (m_hsvChannel.snapshot(factors) && factors != m_hsvFactors.HSV) {
+        m_hsvFactors.HSV = factors;
+        m_redrawRequested.store(true, std::memory_order_release);
+    }
 }
 
 void VulkanRenderer::render() {
     if (!m_initialized) {
         return;
     }
-    if (m_orientationChanged) {
+    // published values equal to the current ones do not need a frame
+    takeHSVFactors();
+    if (!needsRender()) {
+        ++m_frameStats.skipped;
+        return;
+    }
+    // cleared before any state is read, a change arriving meanwhile schedules another frame
+    m_redrawRequested.exchange(false, std::memory_order_acq_rel);
+    const auto start = std::chrono::steady_clock::now();
+    const bool forceRecreate = m_recreateInterval > 0u && m_frameSerial > 0u &&
+                               m_frameSerial % m_recreateInterval == 0u;
+    if (!m_offscreen && (forceRecreate || (m_surfaceChanged && isSwapchainOutdated()))) {
+        // the frame that reported the change was presented from the old swapchain and shown
+        // rotated by the compositor, this one already uses the new transform
+        recreateSwapChain();
+    }
+    m_surfaceChanged = false;
+
+    // CPU work that needs none of the frame's resources overlaps the GPU still using them
+    prepareFrame();
+    const auto prepared = std::chrono::steady_clock::now();
+    m_gfxTimeline.wait(m_frameValues[m_currentFrame]);
+    const auto waited = std::chrono::steady_clock::now();
+    m_frameTimings.prepareMs += millisecondsBetween(start, prepared);
+    m_frameTimings.waitMs += millisecondsBetween(prepared, waited);
+    collectDeletions();
+    integrateStreamedTextures();
+    if (m_offscreen) {
+        renderOffscreen(waited);
         return;
     }
 
-    vkWaitForFences(m_core.getDevice(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE,
-                    UINT64_MAX);
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(
             m_core.getDevice(), m_swapChain, UINT64_MAX, m_imageAvailableSemaphores[m_currentFrame],
             VK_NULL_HANDLE, &imageIndex);
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
         recreateSwapChain();
+        // nothing was drawn, the new swapchain still needs a frame
+        m_redrawRequested.store(true, std::memory_order_release);
         return;
     }
     assert(result == VK_SUCCESS ||
            result == VK_SUBOPTIMAL_KHR);  // failed to acquire swap chain image
+    if (result == VK_SUBOPTIMAL_KHR) {
+        // still presentable, the compositor applies the transform this swapchain misses
+        m_surfaceChanged = true;
+    }
+    const auto acquired = std::chrono::steady_clock::now();
     updateUniformBuffer(m_currentFrame);
 
-    vkResetFences(m_core.getDevice(), 1, &m_inFlightFences[m_currentFrame]);
     vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
 
-    recordCommandBuffer(m_commandBuffers[m_currentFrame], imageIndex);
+    recordCommandBuffer(m_commandBuffers[m_currentFrame], m_swapChainFramebuffers[imageIndex]);
+    const auto recorded = std::chrono::steady_clock::now();
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {m_imageAvailableSemaphores[m_currentFrame]};
-    VkPipelineStageFlags waitStages[] = {
+    std::vector<VkSemaphore> waitSemaphores = {m_imageAvailableSemaphores[m_currentFrame]};
+    std::vector<VkPipelineStageFlags> waitStages = {
             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    takeUploadWaits(waitSemaphores, waitStages);
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
     VkSemaphore signalSemaphores[] = {m_renderFinishedSemaphores[m_currentFrame]};
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    VK_CHECK(vkQueueSubmit(m_queue, 1, &submitInfo,
-                           m_inFlightFences[m_currentFrame]));
+    m_frameValues[m_currentFrame] = m_gfxTimeline.submit(submitInfo);
+    ++m_frameSerial;
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -435,188 +552,391 @@ void VulkanRenderer::render() {
     presentInfo.pImageIndices = &imageIndex;
     presentInfo.pResults = nullptr;
 
-    result = vkQueuePresentKHR(m_queue, &presentInfo);
+    result = m_core.queuePresent(&presentInfo);
     if (result == VK_SUBOPTIMAL_KHR) {
-        m_orientationChanged = true;
+        m_surfaceChanged = true;
     } else if (result == VK_ERROR_OUT_OF_DATE_KHR) {
         recreateSwapChain();
+        m_redrawRequested.store(true, std::memory_order_release);
     } else {
         assert(result == VK_SUCCESS);  // failed to present swap chain image!
     }
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_frameTimings.acquireMs += millisecondsBetween(waited, acquired);
+    m_frameTimings.recordMs += millisecondsBetween(acquired, recorded);
+    m_frameTimings.submitMs += millisecondsBetween(recorded, std::chrono::steady_clock::now());
+    ++m_frameTimings.frames;
+    ++m_frameStats.rendered;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void VulkanRenderer::renderOffscreen(std::chrono::steady_clock::time_point waited) {
+    updateUniformBuffer(m_currentFrame);
+
+    vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
+
+    recordCommandBuffer(m_commandBuffers[m_currentFrame],
+                        m_offscreenTargets[m_currentFrame].framebuffer);
+    const auto recorded = std::chrono::steady_clock::now();
+
+    // no swapchain image to wait for and nothing to present
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    takeUploadWaits(waitSemaphores, waitStages);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
+
+    m_frameValues[m_currentFrame] = m_gfxTimeline.submit(submitInfo);
+    ++m_frameSerial;
+
+    m_lastOffscreenFrame = m_currentFrame;
+    m_frameTimings.recordMs += millisecondsBetween(waited, recorded);
+    m_frameTimings.submitMs += millisecondsBetween(recorded, std::chrono::steady_clock::now());
+    ++m_frameTimings.frames;
+    ++m_frameStats.rendered;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void VulkanRenderer::readOffscreenImage(std::vector<uint8_t> &pixels) {
+    assert(m_initialized && m_offscreen);
+    const OffscreenTarget &target = m_offscreenTargets[m_lastOffscreenFrame];
+    const VkDeviceSize size = static_cast<VkDeviceSize>(m_offscreenExtent.width) *
+                              m_offscreenExtent.height * 4u;
+
+    VkBuffer readbackBuffer;
+    MemoryAllocator::Allocation readbackMemory;
+    createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 readbackBuffer, readbackMemory);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer cmd;
+    VK_CHECK(vkAllocateCommandBuffers(m_core.getDevice(), &allocInfo, &cmd));
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+    // the render pass leaves the target in TRANSFER_SRC_OPTIMAL
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {m_offscreenExtent.width, m_offscreenExtent.height, 1};
+    vkCmdCopyImageToBuffer(cmd, target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           readbackBuffer, 1, &region);
+
+    VkBufferMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.buffer = readbackBuffer;
+    hostBarrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                         0, nullptr, 1, &hostBarrier, 0, nullptr);
+    VK_CHECK(vkEndCommandBuffer(cmd));
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    m_gfxTimeline.wait(m_gfxTimeline.submit(submitInfo));
+    vkFreeCommandBuffers(m_core.getDevice(), m_commandPool, 1, &cmd);
+
+    pixels.resize(size);
+    memcpy(pixels.data(), readbackMemory.mapped, size);
+
+    vkDestroyBuffer(m_core.getDevice(), readbackBuffer, nullptr);
+    m_core.getAllocator().free(readbackMemory);
 }
 
 void VulkanRenderer::createDescriptorPool() {
     std::array<VkDescriptorPoolSize, 2> poolSizes{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = m_framesInFlight;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolSizes[1].descriptorCount = 3u * m_framesInFlight;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolInfo.maxSets = m_framesInFlight;
 
     VK_CHECK(vkCreateDescriptorPool(m_core.getDevice(), &poolInfo, nullptr, &m_descriptorPool));
 }
 
 void VulkanRenderer::createDescriptorSets() {
-    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT,
-                                               m_descriptorSetLayout);
+    std::vector<VkDescriptorSetLayout> layouts(m_framesInFlight, m_descriptorSetLayout);
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    allocInfo.descriptorSetCount = m_framesInFlight;
     allocInfo.pSetLayouts = layouts.data();
 
     VK_CHECK(vkAllocateDescriptorSets(m_core.getDevice(), &allocInfo, m_descriptorSets.data()));
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = m_uniformBuffers[i];
+        // the actual position inside the ring is supplied as dynamic offset at bind time
+        bufferInfo.buffer = m_uniformRing.getBuffer();
         bufferInfo.offset = 0;
         bufferInfo.range = sizeof(UBO_Data);
 
-        VkDescriptorImageInfo imageInfo{};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = m_texture.view;
-        imageInfo.sampler = m_texture.sampler;
-
-        std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = m_descriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet = m_descriptorSets[i];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pImageInfo = &imageInfo;
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = m_descriptorSets[i];
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(m_core.getDevice(), 1, &descriptorWrite, 0, nullptr);
+        writeTextureDescriptor(i);
+    }
+    m_descriptorDirty.fill(false);
+}
 
-        vkUpdateDescriptorSets(m_core.getDevice(), static_cast<uint32_t>(descriptorWrites.size()),
-                               descriptorWrites.data(), 0, nullptr);
+void VulkanRenderer::writeTextureDescriptor(uint32_t frame) {
+    // the set must not be in use by a pending submission
+    std::array<VkDescriptorImageInfo, 3> imageInfos{};
+    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[0].imageView =
+            m_texture.view != VK_NULL_HANDLE ? m_texture.view : m_placeholder.view;
+    imageInfos[0].sampler = m_texture.sampler;
+    // the filtered binding is only sampled on the compute path, but has to stay valid
+    imageInfos[1] = imageInfos[0];
+    if (m_hsvCompute.getOutputView() != VK_NULL_HANDLE) {
+        imageInfos[1].imageView = m_hsvCompute.getOutputView();
     }
+    imageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[2].imageView = m_hsvLut.getView();
+    imageInfos[2].sampler = m_hsvLut.getSampler();
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = m_descriptorSets[frame];
+    descriptorWrite.dstBinding = 1;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfos[0];
+
+    VkWriteDescriptorSet filteredWrite = descriptorWrite;
+    filteredWrite.dstBinding = 2;
+    filteredWrite.pImageInfo = &imageInfos[1];
+
+    VkWriteDescriptorSet lutWrite = descriptorWrite;
+    lutWrite.dstBinding = 3;
+    lutWrite.pImageInfo = &imageInfos[2];
+
+    const std::array<VkWriteDescriptorSet, 3> writes = {descriptorWrite, filteredWrite, lutWrite};
+    vkUpdateDescriptorSets(m_core.getDevice(), static_cast<uint32_t>(writes.size()),
+                           writes.data(), 0, nullptr);
 }
 
 void VulkanRenderer::updateUniformBuffer(uint32_t currentImage) {
-    UBO_Data ubo{};
-    getPrerotationMatrix(m_core.getSurfaceCaps(), m_pretransformFlag,
-                         ubo.MVP);
-    void *data;
-    vkMapMemory(m_core.getDevice(), m_uniformBuffersMemory[currentImage], 0, sizeof(ubo), 0,
-                &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vkUnmapMemory(m_core.getDevice(), m_uniformBuffersMemory[currentImage]);
+    // the frame's previous submission completed, so its partition is free to overwrite
+    m_uniformRing.beginFrame(currentImage);
+    m_uboOffset = m_uniformRing.push(m_preparedUbo);
 }
 
 void VulkanRenderer::recordCommandBuffer(VkCommandBuffer commandBuffer,
-                                         uint32_t imageIndex) {
+                                         VkFramebuffer framebuffer) {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = 0;
     beginInfo.pInheritanceInfo = nullptr;
 
-    const auto &extent = m_core.getSurfaceCaps().currentExtent;
+    const auto extent = getRenderExtent();
+
+    // the draws are recorded by the workers while this thread records the passes before them
+    m_recorder.beginFrame(m_currentFrame, m_renderPass, framebuffer);
+    const DrawState drawState = {extent, m_descriptorSets[m_currentFrame], m_uboOffset,
+                                 m_hsvFactors};
+    m_recorder.submit([this, drawState](VkCommandBuffer cmd) {
+        recordQuad(cmd, drawState, 0u); // left quad, unfiltered
+    });
+    m_recorder.submit([this, drawState](VkCommandBuffer cmd) {
+        recordQuad(cmd, drawState, 6u); // right quad, filtered
+    });
 
     VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
 
+    for (const auto &upload: m_pendingUploads) {
+        m_streamer.recordFinalize(commandBuffer, upload);
+    }
+
+    // re-filters the texture or re-bakes the LUT only when the factors or the texture changed
+    if (m_frameFilterPath == FilterPath::Compute) {
+        m_hsvCompute.record(commandBuffer, m_currentFrame, m_hsvFactors.HSV);
+    } else if (m_frameFilterPath == FilterPath::Lut) {
+        m_hsvLut.record(commandBuffer, m_hsvFactors.HSV);
+    }
+
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = m_renderPass;
-    renderPassInfo.framebuffer = m_swapChainFramebuffers[imageIndex];
+    renderPassInfo.framebuffer = framebuffer;
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = extent;
 
+    VkClearValue clearColor = {{{0.5f, 0.5f, 0.0f, 1.0f}}};
+
+    renderPassInfo.clearValueCount = 1;
+    renderPassInfo.pClearValues = &clearColor;
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, m_recorder.getSubpassContents());
+    m_recorder.execute(commandBuffer);
+    vkCmdEndRenderPass(commandBuffer);
+    VK_CHECK(vkEndCommandBuffer(commandBuffer));
+}
+
+void VulkanRenderer::recordQuad(VkCommandBuffer commandBuffer, const DrawState &state,
+                                uint32_t firstVertex) const {
+    // secondary buffers inherit no state, every draw sets up its own
     VkViewport viewport{};
-    viewport.width = (float) extent.width;
-    viewport.height = (float) extent.height;
+    viewport.width = (float) state.extent.width;
+    viewport.height = (float) state.extent.height;
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor{};
-    scissor.extent = extent;
+    scissor.extent = state.extent;
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    VkClearValue clearColor = {{{0.5f, 0.5f, 0.0f, 1.0f}}};
-
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
-                         VK_SUBPASS_CONTENTS_INLINE);
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                       m_graphicsPipeline);
     vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_pipelineLayout, 0, 1, &m_descriptorSets[m_currentFrame],
-                            0, nullptr);
+                            m_pipelineLayout, 0, 1, &state.descriptorSet,
+                            1, &state.uboOffset);
 
     vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
-                       sizeof(PushConstant_Data), &m_hsvFactors);
+                       sizeof(PushConstant_Data), &state.constants);
 
-    vkCmdDraw(commandBuffer, 12, 1, 0, 0);
-    vkCmdEndRenderPass(commandBuffer);
-    VK_CHECK(vkEndCommandBuffer(commandBuffer));
+    // the vertex shader picks the quad from gl_VertexIndex, which includes firstVertex
+    vkCmdDraw(commandBuffer, 6, 1, firstVertex, 0);
 }
 
 void VulkanRenderer::cleanupSwapChain() {
-    for (size_t i = 0; i < m_swapChainFramebuffers.size(); i++) {
-        vkDestroyFramebuffer(m_core.getDevice(), m_swapChainFramebuffers[i], nullptr);
-    }
+    RetiredSwapchain current{m_swapChain, std::move(m_swapChainImageViews),
+                             std::move(m_swapChainFramebuffers)};
+    destroySwapchain(current);
+    m_swapChain = VK_NULL_HANDLE;
+    m_swapChainImages.clear();
+    m_swapChainImageViews.clear();
+    m_swapChainFramebuffers.clear();
+}
 
-    for (size_t i = 0; i < m_swapChainImageViews.size(); i++) {
-        vkDestroyImageView(m_core.getDevice(), m_swapChainImageViews[i], nullptr);
+void VulkanRenderer::cleanupOffscreenTargets() {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        OffscreenTarget &target = m_offscreenTargets[i];
+        vkDestroyFramebuffer(m_core.getDevice(), target.framebuffer, nullptr);
+        vkDestroyImageView(m_core.getDevice(), target.view, nullptr);
+        vkDestroyImage(m_core.getDevice(), target.image, nullptr);
+        m_core.getAllocator().free(target.mem);
+        target = {};
     }
-
-    vkDestroySwapchainKHR(m_core.getDevice(), m_swapChain, nullptr);
 }
 
 void VulkanRenderer::cleanup() {
-    vkDeviceWaitIdle(m_core.getDevice());
-    cleanupSwapChain();
+    if (!m_initialized) {
+        return;
+    }
+    LOGI("Frames rendered %llu, skipped %llu",
+         static_cast<unsigned long long>(m_frameStats.rendered),
+         static_cast<unsigned long long>(m_frameStats.skipped));
+    if (m_frameTimings.frames > 0u) {
+        const double frames = double(m_frameTimings.frames);
+        LOGI("%u frames in flight, per frame ms: prepare %.3f, frame wait %.3f, acquire %.3f, "
+             "record %.3f, submit %.3f", m_framesInFlight, m_frameTimings.prepareMs / frames,
+             m_frameTimings.waitMs / frames, m_frameTimings.acquireMs / frames,
+             m_frameTimings.recordMs / frames, m_frameTimings.submitMs / frames);
+    }
+    if (m_swapchainStats.recreations > 0u) {
+        LOGI("Swapchain recreated %u times, stall %.2f ms average, %.2f ms max",
+             m_swapchainStats.recreations,
+             m_swapchainStats.totalStallMs / m_swapchainStats.recreations,
+             m_swapchainStats.maxStallMs);
+    }
+    const DeletionQueue::Stats deletionStats = m_deletionQueue.getStats();
+    LOGI("Deferred deletions %llu, at most %zu pending",
+         static_cast<unsigned long long>(deletionStats.deleted), deletionStats.peakPending);
+    const auto recordingStats = m_recorder.getThreadStats();
+    for (size_t thread = 0; thread < recordingStats.size(); ++thread) {
+        const auto &stats = recordingStats[thread];
+        LOGI("Recording thread %zu: %llu jobs, %.1f us per job", thread,
+             static_cast<unsigned long long>(stats.jobs),
+             stats.jobs ? stats.recordMs * 1e3 / double(stats.jobs) : 0.0);
+    }
+    // the worker submits to the queues too, stop it before waiting for them
+    m_streamer.destroy();
+    m_core.waitIdle();
+    // the only full drain left, teardown has no frame to wait for anymore
+    m_deletionQueue.flush();
+    m_gfxTimeline.destroy();
+    if (m_offscreen) {
+        cleanupOffscreenTargets();
+    } else {
+        cleanupSwapChain();
+    }
+
+    for (const auto &upload: m_pendingUploads) {
+        vkDestroySemaphore(m_core.getDevice(), upload.ready, nullptr);
+    }
+    m_pendingUploads.clear();
 
-    vkDestroyImageView(m_core.getDevice(), m_texture.view, nullptr);
-    vkDestroyImage(m_core.getDevice(), m_texture.image, nullptr);
-    vkFreeMemory(m_core.getDevice(), m_texture.mem, nullptr);
+    m_hsvCompute.destroy();
+    m_hsvLut.destroy();
+    vkDestroySampler(m_core.getDevice(), m_texture.sampler, nullptr);
+    destroyTexture(m_texture);
+    destroyTexture(m_placeholder);
 
     vkDestroyDescriptorPool(m_core.getDevice(), m_descriptorPool, nullptr);
 
     vkDestroyDescriptorSetLayout(m_core.getDevice(), m_descriptorSetLayout, nullptr);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroyBuffer(m_core.getDevice(), m_uniformBuffers[i], nullptr);
-        vkFreeMemory(m_core.getDevice(), m_uniformBuffersMemory[i], nullptr);
-    }
+    m_uniformRing.destroy();
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         vkDestroySemaphore(m_core.getDevice(), m_imageAvailableSemaphores[i], nullptr);
         vkDestroySemaphore(m_core.getDevice(), m_renderFinishedSemaphores[i], nullptr);
-        vkDestroyFence(m_core.getDevice(), m_inFlightFences[i], nullptr);
     }
+    m_recorder.destroy();
     vkDestroyCommandPool(m_core.getDevice(), m_commandPool, nullptr);
     vkDestroyPipeline(m_core.getDevice(), m_graphicsPipeline, nullptr);
     vkDestroyPipelineLayout(m_core.getDevice(), m_pipelineLayout, nullptr);
     vkDestroyRenderPass(m_core.getDevice(), m_renderPass, nullptr);
-    vkDestroyDevice(m_core.getDevice(), nullptr);
-    vkDestroySurfaceKHR(m_core.getInstance(), m_core.getSurface(), nullptr);
-    vkDestroyInstance(m_core.getInstance(), nullptr);
+    m_pipelineCache.destroy();
+    m_stagingPool.destroy();
+    m_core.clean();
     m_initialized = false;
 }
 
-void VulkanRenderer::createSwapChain() {
-    const VkSurfaceCapabilitiesKHR &surfaceCaps = m_core.getSurfaceCaps();
+void VulkanRenderer::createSwapChain(VkSwapchainKHR oldSwapchain) {
+    const VulkanCore::SurfaceState &surface = m_core.refreshSurfaceState();
+    const VkSurfaceCapabilitiesKHR &surfaceCaps = surface.caps;
 
     assert(surfaceCaps.currentExtent.width != -1);
 
-    m_pretransformFlag = surfaceCaps.currentTransform;
+    // all four rotations are pre-rotated in the vertex shader, the compositor has nothing
+    // left to do; the transform and extent stay cached with the swapchain
+    m_pretransformFlag = surface.transform;
+    m_swapchainExtent = surfaceCaps.currentExtent;
+    m_swapchainPreRotation = surface.preRotation;
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -632,7 +952,7 @@ void VulkanRenderer::createSwapChain() {
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
     createInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = oldSwapchain;
 
     VK_CHECK(vkCreateSwapchainKHR(m_core.getDevice(), &createInfo, nullptr, &m_swapChain));
 
@@ -668,9 +988,17 @@ void VulkanRenderer::createImageViews() {
     }
 }
 
+VkFormat VulkanRenderer::getColorFormat() const {
+    return m_offscreen ? OFFSCREEN_FORMAT : m_core.getSurfaceFormat().format;
+}
+
+VkExtent2D VulkanRenderer::getRenderExtent() const {
+    return m_offscreen ? m_offscreenExtent : m_swapchainExtent;
+}
+
 void VulkanRenderer::createRenderPass() {
     VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = m_core.getSurfaceFormat().format;
+    colorAttachment.format = getColorFormat();
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
 
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
@@ -680,7 +1008,9 @@ void VulkanRenderer::createRenderPass() {
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // offscreen targets are handed over to transfer for readback instead of presentation
+    colorAttachment.finalLayout = m_offscreen ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                              : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
@@ -691,7 +1021,8 @@ void VulkanRenderer::createRenderPass() {
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
 
-    VkSubpassDependency dependency{};
+    std::array<VkSubpassDependency, 2> dependencies{};
+    VkSubpassDependency &dependency = dependencies[0];
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
     dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -699,26 +1030,43 @@ void VulkanRenderer::createRenderPass() {
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
+    if (m_offscreen) {
+        // the previous readback of the same target has to finish before it is cleared
+        dependency.srcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+        VkSubpassDependency &readback = dependencies[1];
+        readback.srcSubpass = 0;
+        readback.dstSubpass = VK_SUBPASS_EXTERNAL;
+        readback.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        readback.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        readback.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        readback.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    }
+
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderPassInfo.attachmentCount = 1;
     renderPassInfo.pAttachments = &colorAttachment;
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
+    renderPassInfo.dependencyCount = m_offscreen ? 2u : 1u;
+    renderPassInfo.pDependencies = dependencies.data();
 
     VK_CHECK(vkCreateRenderPass(m_core.getDevice(), &renderPassInfo, nullptr, &m_renderPass));
 }
 
+void VulkanRenderer::createPipelineCache() {
+    m_pipelineCache.init(m_core.getDevice(), m_core.getPhysDeviceProps(), m_pipelineCachePath);
+}
+
 void VulkanRenderer::createGraphicsPipeline() {
-    auto vertShaderCode =
-            LoadBinaryFileToVector("shaders/shader.vert.spv", m_core.getAssetManager());
-    auto fragShaderCode =
-            LoadBinaryFileToVector("shaders/shader.frag.spv", m_core.getAssetManager());
+    auto vertShaderCode = m_core.getAssets().map("shaders/shader.vert.spv");
+    auto fragShaderCode = m_core.getAssets().map("shaders/shader.frag.spv");
 
-    VkShaderModule vertShaderModule = createShaderModule(m_core.getDevice(), vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(m_core.getDevice(),fragShaderCode);
+    VkShaderModule vertShaderModule = createShaderModule(m_core.getDevice(), vertShaderCode.data(),
+                                                         vertShaderCode.size());
+    VkShaderModule fragShaderModule = createShaderModule(m_core.getDevice(), fragShaderCode.data(),
+                                                         fragShaderCode.size());
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType =
@@ -839,18 +1187,52 @@ void VulkanRenderer::createGraphicsPipeline() {
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
-    VK_CHECK(vkCreateGraphicsPipelines(m_core.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo,
-                                       nullptr, &m_graphicsPipeline));
+    const auto start = std::chrono::steady_clock::now();
+    VK_CHECK(vkCreateGraphicsPipelines(m_core.getDevice(), m_pipelineCache.get(), 1,
+                                       &pipelineInfo, nullptr, &m_graphicsPipeline));
+    const auto end = std::chrono::steady_clock::now();
+    LOGI("Graphics pipeline created in %.2f ms (%s pipeline cache)",
+         std::chrono::duration<double, std::milli>(end - start).count(),
+         m_pipelineCache.isWarm() ? "warm" : "cold");
+    m_pipelineCache.saveAsync();
     vkDestroyShaderModule(m_core.getDevice(), fragShaderModule, nullptr);
     vkDestroyShaderModule(m_core.getDevice(), vertShaderModule, nullptr);
 }
 
+void VulkanRenderer::createHsvComputePass() {
+#ifdef HSV_COMPUTE_FILTER
+    if (!HsvComputePass::isSupported(m_core)) {
+        LOGI("Compute HSV filter is not supported, filtering per fragment");
+        return;
+    }
+    m_hsvCompute.init(m_core, m_pipelineCache.get(), m_framesInFlight, getDeferDestroy());
+    m_pipelineCache.saveAsync();
+#else
+    LOGI("Compute HSV filter is not enabled in this build, filtering per fragment");
+#endif
+}
+
+void VulkanRenderer::initFilterImages() {
+    // bindings 2 and 3 of every set point at these images whatever the filter path, so they
+    // have to be readable before the first frame samples anything
+    if (m_hsvCompute.isReady() &&
+        m_hsvCompute.setSource(m_placeholder.view, m_texture.sampler, m_placeholder.width,
+                               m_placeholder.height)) {
+        m_descriptorDirty.fill(true);
+    }
+    submitOneTimeCommands([this](VkCommandBuffer cmd) {
+        if (m_hsvCompute.isReady()) {
+            m_hsvCompute.record(cmd, 0u, m_hsvFactors.HSV);
+        }
+        m_hsvLut.record(cmd, m_hsvFactors.HSV);
+    });
+}
+
 void VulkanRenderer::createFramebuffers() {
+    const auto &extent = m_swapchainExtent;
     for (size_t i = 0; i < m_swapChainImageViews.size(); i++) {
         VkImageView attachments[] = {m_swapChainImageViews[i]};
 
-        const auto &extent = m_core.getSurfaceCaps().currentExtent;
-
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = m_renderPass;
@@ -865,6 +1247,49 @@ void VulkanRenderer::createFramebuffers() {
     }
 }
 
+void VulkanRenderer::createOffscreenTargets() {
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
+        OffscreenTarget &target = m_offscreenTargets[i];
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = OFFSCREEN_FORMAT;
+        imageInfo.extent = {m_offscreenExtent.width, m_offscreenExtent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VK_CHECK(vkCreateImage(m_core.getDevice(), &imageInfo, nullptr, &target.image));
+        target.mem = m_core.getAllocator().allocateForImage(target.image,
+                                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                            VK_IMAGE_TILING_OPTIMAL);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = target.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = OFFSCREEN_FORMAT;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        VK_CHECK(vkCreateImageView(m_core.getDevice(), &viewInfo, nullptr, &target.view));
+
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = m_renderPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &target.view;
+        framebufferInfo.width = m_offscreenExtent.width;
+        framebufferInfo.height = m_offscreenExtent.height;
+        framebufferInfo.layers = 1;
+        VK_CHECK(vkCreateFramebuffer(m_core.getDevice(), &framebufferInfo, nullptr,
+                                     &target.framebuffer));
+    }
+}
+
 void VulkanRenderer::createCommandPool() {
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -878,7 +1303,7 @@ void VulkanRenderer::createCommandBuffer() {
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = m_commandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = m_commandBuffers.size();
+    allocInfo.commandBufferCount = m_framesInFlight;
 
     VK_CHECK(vkAllocateCommandBuffers(m_core.getDevice(), &allocInfo, m_commandBuffers.data()));
 }
@@ -887,16 +1312,13 @@ void VulkanRenderer::createSyncObjects() {
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    // frames wait for their previous submission on m_gfxTimeline, value 0 never blocks
+    m_frameValues.fill(0u);
+    for (uint32_t i = 0; i < m_framesInFlight; i++) {
         VK_CHECK(vkCreateSemaphore(m_core.getDevice(), &semaphoreInfo, nullptr,
                                    &m_imageAvailableSemaphores[i]));
 
         VK_CHECK(vkCreateSemaphore(m_core.getDevice(), &semaphoreInfo, nullptr,
                                    &m_renderFinishedSemaphores[i]));
-
-        VK_CHECK(vkCreateFence(m_core.getDevice(), &fenceInfo, nullptr, &m_inFlightFences[i]));
     }
 }
\ No newline at end of file
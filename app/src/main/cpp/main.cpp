@@ -4,9 +4,15 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/system_properties.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 
+#include "ParamBlock.h"
+#include "PlatformAndroid.h"
 #include "VulkanRenderer.h"
 
 /*
@@ -38,10 +44,22 @@ static void HandleCmd(struct android_app *app, int32_t cmd) {
             LOGI("Called - APP_CMD_INIT_WINDOW");
             if (engine->app->window != nullptr) {
                 LOGI("Setting a new surface");
-                engine->app_backend->init(app->window, app->activity->assetManager);
+                engine->app_backend->init(
+                        std::make_unique<Platform::AndroidSurfaceProvider>(app->window),
+                        std::make_unique<Platform::AndroidAssetSource>(
+                                app->activity->assetManager));
                 engine->canRender = true;
             }
             break;
+        case APP_CMD_WINDOW_RESIZED:
+        case APP_CMD_CONFIG_CHANGED:
+            // Rotation or resize, cached surface state has to be refreshed
+            engine->app_backend->onSurfaceChanged();
+            break;
+        case APP_CMD_WINDOW_REDRAW_NEEDED:
+        case APP_CMD_GAINED_FOCUS:
+            engine->app_backend->requestRender();
+            break;
         case APP_CMD_TERM_WINDOW:
             // The window is being hidden or closed
             engine->canRender = false;
@@ -83,8 +101,12 @@ static void HandleInputEvents(struct android_app *app) {
     // listening to AKEYCODE_BACK). This sample has done that in the Kotlin side
     // and not processing other input events, we just reset the event counter
     // inside the android_input_buffer to keep app glue code in a working state.
+    if (inputBuf->motionEventsCount > 0 || inputBuf->keyEventsCount > 0) {
+        // handled input may change what is shown
+        ((VulkanEngine *) app->userData)->app_backend->requestRender();
+    }
     android_app_clear_motion_events(inputBuf);
-    android_app_clear_motion_events(inputBuf);
+    android_app_clear_key_events(inputBuf);
 }
 
 /*
@@ -95,30 +117,115 @@ static void HandleInputEvents(struct android_app *app) {
 
 VulkanEngine engine{};
 VulkanRenderer vulkanBackend{};
+// filter parameters Kotlin writes without a JNI call, polled by the render loop
+ParamBlock paramBlock{};
+// every JNI entry point counts itself, logged per second next to the parameter writes
+std::atomic<uint32_t> jniCalls{0u};
+
+using Clock = std::chrono::steady_clock;
+
+// keep polling the parameter block this long after its last write before blocking, so a
+// slider drag with short pauses does not need a JNI wake call per pause
+static constexpr auto PARAM_LINGER = std::chrono::milliseconds(500);
+static constexpr int PARAM_POLL_INTERVAL_MS = 8;
+
+/*
+ * Looper timeout for the next poll: 0 while a frame is due, a short interval while the
+ * parameter block is being written, otherwise block until ALooper_wake.
+ */
+static int GetPollTimeout(Clock::time_point lingerEnd) {
+    if (engine.canRender && engine.app_backend->needsRender()) {
+        return 0;
+    }
+    if (Clock::now() < lingerEnd) {
+        return PARAM_POLL_INTERVAL_MS;
+    }
+    return paramBlock.enterIdle() ? -1 : 0;
+}
+
+/*
+ * Logs JNI calls and shared parameter writes per second while either is happening
+ */
+static void LogParamRates() {
+    static Clock::time_point windowStart = Clock::now();
+    static uint32_t windowWrites = 0u;
+    const auto elapsed = Clock::now() - windowStart;
+    if (elapsed < std::chrono::seconds(1)) {
+        return;
+    }
+    const uint32_t calls = jniCalls.exchange(0u, std::memory_order_relaxed);
+    const uint32_t writes = paramBlock.getWriteCount() - windowWrites;
+    if (calls > 0u || writes > 0u) {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        LOGI("JNI calls %.1f/s, shared parameter writes %.1f/s", calls / seconds,
+             writes / seconds);
+    }
+    windowStart += elapsed;
+    windowWrites += writes;
+}
+
+static uint32_t GetUintProperty(const char *name, uint32_t fallback) {
+    char value[PROP_VALUE_MAX] = {};
+    if (__system_property_get(name, value) <= 0) {
+        return fallback;
+    }
+    return static_cast<uint32_t>(strtoul(value, nullptr, 10));
+}
 
 void android_main(struct android_app *state) {
     engine.app = state;
     engine.app_backend = &vulkanBackend;
     state->userData = &engine;
     state->onAppCmd = HandleCmd;
+    vulkanBackend.setPipelineCachePath(std::string(state->activity->internalDataPath) +
+                                       "/pipeline_cache.bin");
+
+    // JNI calls and the texture streamer request frames from other threads
+    vulkanBackend.setWakeCallback([looper = state->looper]() { ALooper_wake(looper); });
+    // adb shell setprop debug.myapp.continuous 1 redraws at vsync rate for profiling
+    char continuous[PROP_VALUE_MAX] = {};
+    __system_property_get("debug.myapp.continuous", continuous);
+    vulkanBackend.setContinuous(!strcmp(continuous, "1"));
+    // adb shell setprop debug.myapp.record_threads N records the draws on N worker threads
+    vulkanBackend.setRecordingThreads(GetUintProperty("debug.myapp.record_threads", 0u));
+    // adb shell setprop debug.myapp.frames_in_flight 1..3 trades latency for throughput
+    vulkanBackend.setFramesInFlight(GetUintProperty("debug.myapp.frames_in_flight", 2u));
+    // adb shell setprop debug.myapp.recreate_interval N recreates the swapchain every N frames,
+    // together with debug.myapp.continuous it benchmarks the recreation stall
+    vulkanBackend.setRecreateInterval(GetUintProperty("debug.myapp.recreate_interval", 0u));
+    // adb shell setprop debug.myapp.compressed_textures 1 streams KTX2 variants of the assets
+    vulkanBackend.setCompressedTextures(
+            GetUintProperty("debug.myapp.compressed_textures", 0u) != 0u);
 
     android_app_set_key_event_filter(state, VulkanKeyEventFilter);
     android_app_set_motion_event_filter(state, VulkanMotionEventFilter);
 
+    Clock::time_point lingerEnd{};
     while (true) {
         int ident;
         int events;
         android_poll_source *source;
-        while ((ident = ALooper_pollAll(engine.canRender ? 0 : -1, nullptr, &events,
+        // block in the looper unless a frame is due, ALooper_wake ends the wait early
+        while ((ident = ALooper_pollAll(GetPollTimeout(lingerEnd), nullptr, &events,
                                         (void **) &source)) >= 0) {
             if (source != nullptr) {
                 source->process(state, source);
             }
         }
+        paramBlock.leaveIdle();
 
         HandleInputEvents(state);
 
-        engine.app_backend->render();
+        std::array<float, 3> factors{};
+        if (paramBlock.poll(factors)) {
+            engine.app_backend->setHSVFactors(factors[0], factors[1], factors[2]);
+            lingerEnd = Clock::now() + PARAM_LINGER;
+        }
+        LogParamRates();
+
+        if (engine.canRender) {
+            engine.app_backend->render();
+        }
     }
 }
 
@@ -127,6 +234,38 @@ JNIEXPORT jboolean JNICALL
 Java_com_android_myapp_VulkanActivity_applyFilterOverJNI(JNIEnv *env, jobject thiz,
                                                          jfloat hue_factor, jfloat saturation_facto,
                                                          jfloat intensity_facto) {
+    jniCalls.fetch_add(1u, std::memory_order_relaxed);
     vulkanBackend.setHSVFactors(hue_factor, saturation_facto, intensity_facto);
     return true;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_android_myapp_ParamBlock_registerBuffer(JNIEnv *env, jclass clazz, jobject buffer) {
+    jniCalls.fetch_add(1u, std::memory_order_relaxed);
+    // adb shell setprop debug.myapp.param_block 1 before launch shares the factors through
+    // the buffer; off by default until the JNI call rates of both paths are logged on devices
+    if (GetUintProperty("debug.myapp.param_block", 0u) == 0u) {
+        LOGI("Parameter block disabled, filter changes go through JNI calls");
+        return false;
+    }
+    // the Kotlin block lives as long as the process, the global ref keeps it from being
+    // collected underneath the render loop
+    void *memory = env->GetDirectBufferAddress(buffer);
+    const jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!memory || capacity < 0 || !paramBlock.attach(memory, size_t(capacity))) {
+        LOGE("Parameter block rejected, falling back to JNI calls");
+        return false;
+    }
+    env->NewGlobalRef(buffer);
+    return true;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_android_myapp_ParamBlock_wakeRenderLoop(JNIEnv *env, jclass clazz) {
+    jniCalls.fetch_add(1u, std::memory_order_relaxed);
+    if (engine.app) {
+        ALooper_wake(engine.app->looper);
+    }
 }
\ No newline at end of file
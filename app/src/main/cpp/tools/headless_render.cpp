@@ -0,0 +1,158 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+/*
+ * Host driver for the offscreen renderer: renders a number of frames without any
+ * window and reports throughput, optionally dumping the last frame as a PPM image.
+ *
+ * usage: headless_render [--assets DIR] [--size WIDTHxHEIGHT] [--frames N] [--out FILE.ppm]
+ *                        [--pipeline-cache FILE] [--filter fragment|compute|lut]
+ *                        [--record-threads N] [--frames-in-flight 1..3]
+ *                        [--compressed-textures] [--swap-texture ASSET]
+ * --filter compute renders the fragment path unless built with -DHSV_COMPUTE_FILTER=ON.
+ * --swap-texture streams ASSET halfway through the measured frames, the old texture is
+ * released once the frames sampling it completed.
+ * VK_ICD_FILENAMES may point at lavapipe or SwiftShader to run without a GPU.
+ */
+
+#include "PlatformLinux.h"
+#include "VulkanRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifndef HOST_ASSETS_DIR
+#define HOST_ASSETS_DIR "assets"
+#endif
+
+static bool writePPM(const char *path, const std::vector<uint8_t> &rgba,
+                     uint32_t width, uint32_t height) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P6\n%u %u\n255\n", width, height);
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        fwrite(&rgba[i], 1, 3, file);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool parseFilterPath(const char *name, VulkanRenderer::FilterPath &path) {
+    if (!strcmp(name, "fragment")) {
+        path = VulkanRenderer::FilterPath::Fragment;
+    } else if (!strcmp(name, "compute")) {
+        path = VulkanRenderer::FilterPath::Compute;
+    } else if (!strcmp(name, "lut")) {
+        path = VulkanRenderer::FilterPath::Lut;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    std::string assetsDir = HOST_ASSETS_DIR;
+    uint32_t width = 1920u;
+    uint32_t height = 1080u;
+    uint32_t frames = 300u;
+    const char *outPath = nullptr;
+    const char *pipelineCachePath = nullptr;
+    VulkanRenderer::FilterPath filterPath = VulkanRenderer::FilterPath::Fragment;
+    uint32_t recordThreads = 0u;
+    uint32_t framesInFlight = 2u;
+    bool compressedTextures = false;
+    const char *swapTexture = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--assets") && i + 1 < argc) {
+            assetsDir = argv[++i];
+        } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            sscanf(argv[++i], "%ux%u", &width, &height);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--pipeline-cache") && i + 1 < argc) {
+            pipelineCachePath = argv[++i];
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc &&
+                   parseFilterPath(argv[i + 1], filterPath)) {
+            ++i;
+        } else if (!strcmp(argv[i], "--record-threads") && i + 1 < argc) {
+            recordThreads = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--frames-in-flight") && i + 1 < argc) {
+            framesInFlight = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--compressed-textures")) {
+            compressedTextures = true;
+        } else if (!strcmp(argv[i], "--swap-texture") && i + 1 < argc) {
+            swapTexture = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--assets DIR] [--size WxH] [--frames N] [--out FILE.ppm]"
+                            " [--pipeline-cache FILE] [--filter fragment|compute|lut]"
+                            " [--record-threads N] [--frames-in-flight 1..3]"
+                            " [--compressed-textures] [--swap-texture ASSET]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    VulkanRenderer renderer;
+    if (pipelineCachePath) {
+        renderer.setPipelineCachePath(pipelineCachePath);
+    }
+    renderer.setFilterPath(filterPath);
+    renderer.setRecordingThreads(recordThreads);
+    renderer.setFramesInFlight(framesInFlight);
+    renderer.setCompressedTextures(compressedTextures);
+    // nothing changes between frames, every render() call has to submit to measure anything
+    renderer.setContinuous(true);
+    renderer.initOffscreen(std::make_unique<Platform::FileAssetSource>(assetsDir), width, height);
+
+    // first frame includes lazy driver work, keep it out of the measurement
+    renderer.render();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; ++i) {
+        if (swapTexture && i == frames / 2u) {
+            renderer.requestTexture(swapTexture);
+        }
+        renderer.render();
+    }
+    std::vector<uint8_t> pixels;
+    renderer.readOffscreenImage(pixels);
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%u frames at %ux%u in %.3f s: %.1f fps, %.1f Mpix/s\n", frames, width, height,
+           seconds, frames / seconds, frames * double(width) * height / seconds / 1e6);
+    const VulkanRenderer::FrameStats stats = renderer.getFrameStats();
+    printf("rendered %llu, skipped %llu\n", static_cast<unsigned long long>(stats.rendered),
+           static_cast<unsigned long long>(stats.skipped));
+    // the warm-up frame is included, it hardly moves the averages
+    const VulkanRenderer::FrameTimings timings = renderer.getFrameTimings();
+    const double timedFrames = double(std::max<uint64_t>(timings.frames, 1u));
+    printf("per frame ms: prepare %.3f, frame wait %.3f, record %.3f, submit %.3f\n",
+           timings.prepareMs / timedFrames, timings.waitMs / timedFrames,
+           timings.recordMs / timedFrames, timings.submitMs / timedFrames);
+    const auto recordingStats = renderer.getRecordingStats();
+    for (size_t thread = 0; thread < recordingStats.size(); ++thread) {
+        const auto &threadStats = recordingStats[thread];
+        printf("%s %zu: %llu draws recorded, %.1f us per draw\n",
+               recordThreads ? "recording worker" : "render thread", thread,
+               static_cast<unsigned long long>(threadStats.jobs),
+               threadStats.jobs ? threadStats.recordMs * 1e3 / double(threadStats.jobs) : 0.0);
+    }
+
+    if (outPath && !writePPM(outPath, pixels, width, height)) {
+        fprintf(stderr, "failed to write %s\n", outPath);
+        return 1;
+    }
+
+    renderer.cleanup();
+    return 0;
+}
@@ -0,0 +1,608 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+/*
+ * Throughput of the two HSV filter paths on camera sized images. Every pixel of a
+ * WIDTHxHEIGHT target is filtered by
+ *   fragment - shader.frag running the RGB->HSV->RGB round trip per fragment (every frame)
+ *   compute  - one hsv_filter.comp dispatch over the texture (only when the factors change)
+ *   sample   - shader.frag sampling the compute output (every frame of the compute path)
+ *   lut      - shader.frag with one lookup into the HsvLut lattice (every frame)
+ * Each pass is recorded N times into one command buffer and timed by the host around
+ * submit + fence wait. HsvFilter on the CPU is measured on the same images with every
+ * instruction set the host supports on one thread, and with the best one on all cores.
+ *
+ * usage: hsv_filter_bench [--assets DIR] [--size WIDTHxHEIGHT] [--runs N] [--cpu-only]
+ * Without --size the 12 MP (4000x3000) and 48 MP (8000x6000) cases are run.
+ */
+
+#include "HsvComputePass.h"
+#include "HsvFilter.h"
+#include "HsvLut.h"
+#include "PixelKernels.h"
+#include "PlatformLinux.h"
+#include "StagingPool.h"
+#include "VulkanCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef HOST_ASSETS_DIR
+#define HOST_ASSETS_DIR "assets"
+#endif
+
+namespace {
+
+    constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr std::array<float, 3> FACTORS = {0.6f, 0.7f, 0.55f};
+
+    struct PushConstants {
+        float hsv[3];
+        float filterMode;
+    };
+
+    struct Image {
+        VkImage image = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation mem{};
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    class Bench {
+    public:
+        Bench(VulkanCore &core, StagingPool &stagingPool, uint32_t width, uint32_t height)
+                : m_core(core), m_stagingPool(stagingPool), m_width(width), m_height(height) {
+            m_device = m_core.getDevice();
+            createCommandBuffer();
+            createSource();
+            createTarget();
+            createSampler();
+            createGraphicsPipeline();
+            m_compute.init(m_core, VK_NULL_HANDLE, 1u, getDefer());
+            m_compute.setSource(m_source.view, m_sampler, m_width, m_height);
+            m_lut.init(m_core, m_stagingPool, getDefer());
+            submit(1u, [&](VkCommandBuffer cmd) { m_lut.record(cmd, FACTORS); });
+            writeDescriptors();
+        }
+
+        ~Bench() {
+            m_deletions.flush();
+            m_lut.destroy();
+            m_compute.destroy();
+            vkDestroyPipeline(m_device, m_pipeline, nullptr);
+            vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+            vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+            vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+            vkDestroyFramebuffer(m_device, m_framebuffer, nullptr);
+            vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+            vkDestroySampler(m_device, m_sampler, nullptr);
+            destroyImage(m_target);
+            destroyImage(m_source);
+            vkDestroyFence(m_device, m_fence, nullptr);
+            vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        }
+
+        // seconds per repetition
+        double measure(uint32_t runs, const std::function<void(VkCommandBuffer)> &record) {
+            submit(1u, record); // pipelines and images warm
+            const auto start = std::chrono::steady_clock::now();
+            submit(runs, record);
+            return std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count() / runs;
+        }
+
+        void recordDraw(VkCommandBuffer cmd, float filterMode) {
+            VkRenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = m_renderPass;
+            renderPassInfo.framebuffer = m_framebuffer;
+            renderPassInfo.renderArea.extent = {m_width, m_height};
+            vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+            VkViewport viewport{};
+            viewport.width = static_cast<float>(m_width);
+            viewport.height = static_cast<float>(m_height);
+            viewport.maxDepth = 1.0f;
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            VkRect2D scissor{};
+            scissor.extent = {m_width, m_height};
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+            const PushConstants constants{{FACTORS[0], FACTORS[1], FACTORS[2]}, filterMode};
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0,
+                                    1, &m_descriptorSet, 0, nullptr);
+            vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                               sizeof(constants), &constants);
+            vkCmdDraw(cmd, 3, 1, 0, 0);
+            vkCmdEndRenderPass(cmd);
+        }
+
+        void recordDispatch(VkCommandBuffer cmd) {
+            m_compute.invalidate();
+            m_compute.record(cmd, 0u, FACTORS);
+        }
+
+    private:
+        void submit(uint32_t runs, const std::function<void(VkCommandBuffer)> &record) {
+            VK_CHECK(vkResetCommandBuffer(m_cmd, 0));
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            VK_CHECK(vkBeginCommandBuffer(m_cmd, &beginInfo));
+            for (uint32_t i = 0u; i < runs; ++i) {
+                record(m_cmd);
+            }
+            VK_CHECK(vkEndCommandBuffer(m_cmd));
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &m_cmd;
+            VK_CHECK(vkResetFences(m_device, 1, &m_fence));
+            VK_CHECK(m_core.queueSubmit(m_core.getGraphicsQueue(), 1, &submitInfo, m_fence));
+            VK_CHECK(vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, UINT64_MAX));
+            // every submission is waited for, nothing recorded so far is in use anymore
+            m_deletions.flush();
+        }
+
+        DeletionQueue::Defer getDefer() {
+            return [this](std::function<void()> deleter) {
+                m_deletions.push(0u, std::move(deleter));
+            };
+        }
+
+        void createCommandBuffer() {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = static_cast<uint32_t>(m_core.getQueueFamily());
+            VK_CHECK(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool));
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            VK_CHECK(vkAllocateCommandBuffers(m_device, &allocInfo, &m_cmd));
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VK_CHECK(vkCreateFence(m_device, &fenceInfo, nullptr, &m_fence));
+        }
+
+        Image createImage(VkImageUsageFlags usage) {
+            Image image;
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = FORMAT;
+            imageInfo.extent = {m_width, m_height, 1};
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = usage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VK_CHECK(vkCreateImage(m_device, &imageInfo, nullptr, &image.image));
+            image.mem = m_core.getAllocator().allocateForImage(
+                    image.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_TILING_OPTIMAL);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = image.image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = FORMAT;
+            viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            VK_CHECK(vkCreateImageView(m_device, &viewInfo, nullptr, &image.view));
+            return image;
+        }
+
+        void destroyImage(Image &image) {
+            vkDestroyImageView(m_device, image.view, nullptr);
+            vkDestroyImage(m_device, image.image, nullptr);
+            m_core.getAllocator().free(image.mem);
+        }
+
+        void createSource() {
+            m_source = createImage(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+            // smooth gradients with some noise, so hue, saturation and value all vary
+            const VkDeviceSize size = static_cast<VkDeviceSize>(m_width) * m_height * 4u;
+            StagingPool::Buffer staging = m_stagingPool.acquire(size);
+            auto *pixels = static_cast<uint8_t *>(staging.data());
+            uint32_t noise = 0x9e3779b9u;
+            for (uint32_t y = 0u; y < m_height; ++y) {
+                for (uint32_t x = 0u; x < m_width; ++x) {
+                    noise = noise * 1664525u + 1013904223u;
+                    uint8_t *pixel = pixels + (static_cast<size_t>(y) * m_width + x) * 4u;
+                    pixel[0] = static_cast<uint8_t>(x * 255u / m_width + (noise >> 29));
+                    pixel[1] = static_cast<uint8_t>(y * 255u / m_height + (noise >> 27 & 3u));
+                    pixel[2] = static_cast<uint8_t>((x + y) * 127u / (m_width + m_height) +
+                                                    (noise >> 24));
+                    pixel[3] = 255u;
+                }
+            }
+
+            submit(1u, [&](VkCommandBuffer cmd) {
+                Utils::setImageLayout(cmd, m_source.image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      VK_PIPELINE_STAGE_HOST_BIT,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT);
+                VkBufferImageCopy region{};
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                region.imageExtent = {m_width, m_height, 1};
+                vkCmdCopyBufferToImage(cmd, staging.buffer, m_source.image,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                Utils::setImageLayout(cmd, m_source.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                      Utils::SHADER_READ_STAGES);
+            });
+            m_stagingPool.release(staging);
+        }
+
+        void createTarget() {
+            m_target = createImage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+
+            VkAttachmentDescription colorAttachment{};
+            colorAttachment.format = FORMAT;
+            colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            // every pixel is written, a clear would only add bandwidth to the measurement
+            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+            VkAttachmentReference colorAttachmentRef{};
+            colorAttachmentRef.attachment = 0;
+            colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+            VkSubpassDescription subpass{};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = 1;
+            subpass.pColorAttachments = &colorAttachmentRef;
+
+            // repetitions write the same target, and the compute pass output is sampled
+            VkSubpassDependency dependency{};
+            dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+            dependency.dstSubpass = 0;
+            dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+            VkRenderPassCreateInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassInfo.attachmentCount = 1;
+            renderPassInfo.pAttachments = &colorAttachment;
+            renderPassInfo.subpassCount = 1;
+            renderPassInfo.pSubpasses = &subpass;
+            renderPassInfo.dependencyCount = 1;
+            renderPassInfo.pDependencies = &dependency;
+            VK_CHECK(vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass));
+
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = m_renderPass;
+            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.pAttachments = &m_target.view;
+            framebufferInfo.width = m_width;
+            framebufferInfo.height = m_height;
+            framebufferInfo.layers = 1;
+            VK_CHECK(vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_framebuffer));
+        }
+
+        void createSampler() {
+            // 1:1 mapping, the filter only matters at texel edges
+            VkSamplerCreateInfo samplerInfo{};
+            samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            samplerInfo.magFilter = VK_FILTER_LINEAR;
+            samplerInfo.minFilter = VK_FILTER_LINEAR;
+            samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.maxAnisotropy = 1.0f;
+            VK_CHECK(vkCreateSampler(m_device, &samplerInfo, nullptr, &m_sampler));
+        }
+
+        void createGraphicsPipeline() {
+            // the bindings shader.frag uses
+            std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+            for (uint32_t i = 0u; i < bindings.size(); ++i) {
+                bindings[i].binding = i + 1u;
+                bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                bindings[i].descriptorCount = 1;
+                bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            }
+            VkDescriptorSetLayoutCreateInfo layoutInfo{};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+            layoutInfo.pBindings = bindings.data();
+            VK_CHECK(vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout));
+
+            VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3u};
+            VkDescriptorPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.poolSizeCount = 1;
+            poolInfo.pPoolSizes = &poolSize;
+            poolInfo.maxSets = 1;
+            VK_CHECK(vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool));
+
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = m_descriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &m_setLayout;
+            VK_CHECK(vkAllocateDescriptorSets(m_device, &allocInfo, &m_descriptorSet));
+
+            VkPushConstantRange pushConstant{VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                             sizeof(PushConstants)};
+            VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+            pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            pipelineLayoutInfo.setLayoutCount = 1;
+            pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+            pipelineLayoutInfo.pushConstantRangeCount = 1;
+            pipelineLayoutInfo.pPushConstantRanges = &pushConstant;
+            VK_CHECK(vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr,
+                                            &m_pipelineLayout));
+
+            const Platform::AssetView vertCode =
+                    m_core.getAssets().map("shaders/hsv_bench.vert.spv");
+            const Platform::AssetView fragCode = m_core.getAssets().map("shaders/shader.frag.spv");
+            std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+            stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+            stages[0].module = Utils::createShaderModule(m_device, vertCode.data(),
+                                                         vertCode.size());
+            stages[0].pName = "main";
+            stages[1] = stages[0];
+            stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+            stages[1].module = Utils::createShaderModule(m_device, fragCode.data(),
+                                                         fragCode.size());
+
+            VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+            vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+            inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            VkPipelineViewportStateCreateInfo viewportState{};
+            viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            viewportState.viewportCount = 1;
+            viewportState.scissorCount = 1;
+            VkPipelineRasterizationStateCreateInfo rasterizer{};
+            rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+            rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+            rasterizer.cullMode = VK_CULL_MODE_NONE;
+            rasterizer.lineWidth = 1.0f;
+            VkPipelineMultisampleStateCreateInfo multisampling{};
+            multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+            multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+            VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+            colorBlendAttachment.colorWriteMask =
+                    VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                    VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+            VkPipelineColorBlendStateCreateInfo colorBlending{};
+            colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+            colorBlending.attachmentCount = 1;
+            colorBlending.pAttachments = &colorBlendAttachment;
+            const std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                                 VK_DYNAMIC_STATE_SCISSOR};
+            VkPipelineDynamicStateCreateInfo dynamicState{};
+            dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+            dynamicState.pDynamicStates = dynamicStates.data();
+
+            VkGraphicsPipelineCreateInfo pipelineInfo{};
+            pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+            pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+            pipelineInfo.pStages = stages.data();
+            pipelineInfo.pVertexInputState = &vertexInputInfo;
+            pipelineInfo.pInputAssemblyState = &inputAssembly;
+            pipelineInfo.pViewportState = &viewportState;
+            pipelineInfo.pRasterizationState = &rasterizer;
+            pipelineInfo.pMultisampleState = &multisampling;
+            pipelineInfo.pColorBlendState = &colorBlending;
+            pipelineInfo.pDynamicState = &dynamicState;
+            pipelineInfo.layout = m_pipelineLayout;
+            pipelineInfo.renderPass = m_renderPass;
+            pipelineInfo.basePipelineIndex = -1;
+            VK_CHECK(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                                               nullptr, &m_pipeline));
+            vkDestroyShaderModule(m_device, stages[0].module, nullptr);
+            vkDestroyShaderModule(m_device, stages[1].module, nullptr);
+        }
+
+        void writeDescriptors() {
+            std::array<VkDescriptorImageInfo, 3> imageInfos{};
+            imageInfos[0].sampler = m_sampler;
+            imageInfos[0].imageView = m_source.view;
+            imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            imageInfos[1] = imageInfos[0];
+            imageInfos[1].imageView = m_compute.getOutputView();
+            imageInfos[2].sampler = m_lut.getSampler();
+            imageInfos[2].imageView = m_lut.getView();
+            imageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = m_descriptorSet;
+            write.dstBinding = 1;
+            write.descriptorCount = 3; // bindings 1 to 3 are consecutive
+            write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            write.pImageInfo = imageInfos.data();
+            vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+        }
+
+        VulkanCore &m_core;
+        StagingPool &m_stagingPool;
+        VkDevice m_device = VK_NULL_HANDLE;
+        uint32_t m_width;
+        uint32_t m_height;
+
+        VkCommandPool m_commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer m_cmd = VK_NULL_HANDLE;
+        VkFence m_fence = VK_NULL_HANDLE;
+        Image m_source;
+        Image m_target;
+        VkSampler m_sampler = VK_NULL_HANDLE;
+        VkRenderPass m_renderPass = VK_NULL_HANDLE;
+        VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+        VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+        VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_pipeline = VK_NULL_HANDLE;
+        DeletionQueue m_deletions;
+        HsvComputePass m_compute;
+        HsvLut m_lut;
+    };
+
+    // best of N, seconds
+    double measureCpu(uint32_t runs, const std::function<void()> &kernel) {
+        kernel(); // pages in the destination
+        double best = 1e30;
+        for (uint32_t i = 0u; i < runs; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    void benchCpu(const std::vector<VkExtent2D> &sizes, uint32_t runs) {
+        const uint32_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+        printf("CPU, best of %u runs, %u cores\n", runs, cores);
+        printf("%-11s %-9s %7s %10s %10s %10s\n", "size", "isa", "threads", "ms", "MP/s",
+               "MP/s/core");
+        const PixelKernels::Isa best = PixelKernels::getBestIsa();
+        for (const VkExtent2D &size: sizes) {
+            char name[32];
+            snprintf(name, sizeof(name), "%ux%u", size.width, size.height);
+            const double megapixels = double(size.width) * size.height / 1e6;
+            const size_t pitch = size_t(size.width) * 4u;
+            std::vector<uint8_t> src(pitch * size.height);
+            uint32_t noise = 0x9e3779b9u;
+            for (auto &byte: src) {
+                noise = noise * 1664525u + 1013904223u;
+                byte = static_cast<uint8_t>(noise >> 24);
+            }
+            std::vector<uint8_t> dst(src.size());
+
+            const auto run = [&](PixelKernels::Isa isa, uint32_t threads) {
+                PixelKernels::setIsa(isa);
+                const double seconds = measureCpu(runs, [&]() {
+                    HsvFilter::apply(src.data(), pitch, dst.data(), pitch, size.width,
+                                     size.height, FACTORS, threads);
+                });
+                printf("%-11s %-9s %7u %10.2f %10.1f %10.1f\n", name,
+                       PixelKernels::getIsaName(isa), threads, seconds * 1e3,
+                       megapixels / seconds, megapixels / seconds / threads);
+            };
+            for (PixelKernels::Isa isa: {PixelKernels::Isa::Scalar, PixelKernels::Isa::Neon,
+                                         PixelKernels::Isa::Ssse3, PixelKernels::Isa::Avx2}) {
+                if (PixelKernels::isSupported(isa)) {
+                    run(isa, 1u);
+                }
+            }
+            if (cores > 1u) {
+                run(best, cores);
+            }
+        }
+        PixelKernels::setIsa(best);
+
+        // done on the render thread whenever the factors change on the lut path
+        std::vector<uint8_t> lut(size_t(HsvLut::SIZE) * HsvLut::SIZE * HsvLut::SIZE * 4u);
+        const double bakeSeconds = measureCpu(runs, [&]() {
+            HsvFilter::bakeLut(FACTORS, HsvLut::SIZE, lut.data());
+        });
+        printf("lut bake    %u^3 lattice %.3f ms\n", HsvLut::SIZE, bakeSeconds * 1e3);
+    }
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string assetsDir = HOST_ASSETS_DIR;
+    std::vector<VkExtent2D> sizes = {{4000u, 3000u}, {8000u, 6000u}};
+    uint32_t runs = 20u;
+    bool cpuOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--assets") && i + 1 < argc) {
+            assetsDir = argv[++i];
+        } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            VkExtent2D size{};
+            sscanf(argv[++i], "%ux%u", &size.width, &size.height);
+            sizes = {size};
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--cpu-only")) {
+            cpuOnly = true;
+        } else {
+            fprintf(stderr, "usage: %s [--assets DIR] [--size WxH] [--runs N] [--cpu-only]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    benchCpu(sizes, runs);
+    if (cpuOnly) {
+        return 0;
+    }
+    printf("\n");
+
+    VulkanCore core;
+    core.initHeadless(std::make_unique<Platform::FileAssetSource>(assetsDir));
+    if (!HsvComputePass::isSupported(core)) {
+        fprintf(stderr, "the graphics queue of %s has no compute support\n",
+                core.getPhysDeviceProps().deviceName);
+        return 1;
+    }
+    StagingPool stagingPool;
+    stagingPool.init(core.getDevice(), core.getAllocator());
+
+    printf("%s, mean of %u runs recorded into one submission per pass\n",
+           core.getPhysDeviceProps().deviceName, runs);
+    printf("%-11s %-9s %10s %10s\n", "size", "pass", "ms", "MP/s");
+    const uint32_t maxDimension = core.getPhysDeviceProps().limits.maxImageDimension2D;
+    for (const VkExtent2D &size: sizes) {
+        char name[32];
+        snprintf(name, sizeof(name), "%ux%u", size.width, size.height);
+        if (size.width > maxDimension || size.height > maxDimension) {
+            printf("%-11s skipped, maxImageDimension2D is %u\n", name, maxDimension);
+            continue;
+        }
+        const double megapixels = double(size.width) * size.height / 1e6;
+        Bench bench(core, stagingPool, size.width, size.height);
+
+        const struct {
+            const char *name;
+            std::function<void(VkCommandBuffer)> record;
+        } passes[] = {
+                {"fragment", [&](VkCommandBuffer cmd) { bench.recordDraw(cmd, 1.0f); }},
+                {"compute",  [&](VkCommandBuffer cmd) { bench.recordDispatch(cmd); }},
+                {"sample",   [&](VkCommandBuffer cmd) { bench.recordDraw(cmd, 2.0f); }},
+                {"lut",      [&](VkCommandBuffer cmd) { bench.recordDraw(cmd, 3.0f); }},
+        };
+        for (const auto &pass: passes) {
+            const double seconds = bench.measure(runs, pass.record);
+            printf("%-11s %-9s %10.2f %10.1f\n", name, pass.name, seconds * 1e3,
+                   megapixels / seconds);
+        }
+    }
+
+    stagingPool.destroy();
+    core.clean();
+    return 0;
+}
@@ -0,0 +1,505 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+/*
+ * Golden image check of the HSV filter. hsv_filter.comp runs over
+ *   colors  - a 4096x4096 image holding every 24 bit RGB color once
+ *   texture - assets/texture.png
+ * with a few factor sets, and the read back output is compared with HsvFilter on the
+ * CPU. GPUs may evaluate the division with a few ULP of error, so channels are allowed
+ * to differ by --tolerance (2 by default); a histogram of the differences is printed.
+ * Every CPU implementation the host supports is compared with the scalar one as well,
+ * allowing 1 for fused multiply-adds the compiler may form in the scalar loop.
+ * Exits with 1 if anything is off by more than allowed.
+ *
+ * The lut path of shader.frag is checked on the CPU against the same reference: colors in
+ * lattice cells straddling the hue seam at red take the exact filter like in the shader,
+ * every other color has to stay within LUT_TOLERANCE of it.
+ *
+ * usage: hsv_filter_golden [--assets DIR] [--tolerance N] [--cpu-only]
+ */
+
+#include "HsvComputePass.h"
+#include "HsvFilter.h"
+#include "HsvLut.h"
+#include "PixelKernels.h"
+#include "PlatformLinux.h"
+#include "PngDecoder.h"
+#include "StagingPool.h"
+#include "VulkanCore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#ifndef HOST_ASSETS_DIR
+#define HOST_ASSETS_DIR "assets"
+#endif
+
+namespace {
+
+    constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr uint32_t CPU_TOLERANCE = 1u;
+    // worst case of a sweep over the slider range in steps of 1/8, at 0.875 1.0 1.0: doubled
+    // saturation clips channels between lattice points. 225 without the seam fallback
+    constexpr uint32_t LUT_TOLERANCE = 22u;
+
+    // identity first, then the defaults of the app and the extremes of the sliders
+    const std::array<float, 3> FACTOR_SETS[] = {
+            {0.5f, 0.5f, 0.5f},
+            {0.6f, 0.7f, 0.55f},
+            {0.0f, 1.0f, 1.0f},
+            {1.0f, 0.0f, 0.25f},
+            {0.25f, 0.9f, 0.8f},
+            {0.875f, 1.0f, 1.0f},
+    };
+
+    struct Input {
+        std::string name;
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        std::vector<uint8_t> pixels; // tightly packed RGBA8
+    };
+
+    Input makeAllColors() {
+        Input input{"colors", 4096u, 4096u, {}};
+        input.pixels.resize(size_t(input.width) * input.height * 4u);
+        for (uint32_t i = 0u; i < input.width * input.height; ++i) {
+            uint8_t *pixel = &input.pixels[size_t(i) * 4u];
+            pixel[0] = static_cast<uint8_t>(i);
+            pixel[1] = static_cast<uint8_t>(i >> 8);
+            pixel[2] = static_cast<uint8_t>(i >> 16);
+            pixel[3] = static_cast<uint8_t>(i * 97u); // alpha has to pass through untouched
+        }
+        return input;
+    }
+
+    bool loadTexture(const Platform::AssetSource &assets, Input &input) {
+        const Platform::AssetView file = assets.map("texture.png");
+        Png::Info info;
+        if (!Png::readInfo(file.data(), file.size(), info) || !Png::isSupported(info)) {
+            return false;
+        }
+        input = {"texture", info.width, info.height, {}};
+        input.pixels.resize(size_t(info.width) * info.height * 4u);
+        return Png::decodeRGBA8(file.data(), file.size(), input.pixels.data(),
+                                size_t(info.width) * 4u);
+    }
+
+    // differences per channel value, everything above the tolerance is a failure
+    class Comparison {
+    public:
+        explicit Comparison(uint32_t tolerance) : m_tolerance(tolerance) {
+        }
+
+        void add(const std::vector<uint8_t> &result, const std::vector<uint8_t> &reference) {
+            for (size_t i = 0u; i < result.size(); ++i) {
+                const uint32_t diff = static_cast<uint32_t>(std::abs(result[i] - reference[i]));
+                ++m_histogram[std::min(diff, uint32_t(m_histogram.size() - 1u))];
+                if (diff > m_tolerance && m_firstFailure == SIZE_MAX) {
+                    m_firstFailure = i;
+                }
+                m_maxDiff = std::max(m_maxDiff, diff);
+            }
+        }
+
+        bool passed() const {
+            return m_maxDiff <= m_tolerance;
+        }
+
+        void print(const char *name) const {
+            uint64_t total = 0u;
+            for (uint64_t count: m_histogram) {
+                total += count;
+            }
+            printf("%-28s max %3u  %s\n", name, m_maxDiff, passed() ? "ok" : "FAILED");
+            for (size_t diff = 0u; diff < m_histogram.size(); ++diff) {
+                if (m_histogram[diff]) {
+                    const bool last = diff + 1u == m_histogram.size();
+                    printf("    %s%zu: %12llu  %8.4f%%\n", last ? ">=" : "  ", diff,
+                           static_cast<unsigned long long>(m_histogram[diff]),
+                           100.0 * m_histogram[diff] / total);
+                }
+            }
+            if (!passed()) {
+                printf("    first failing byte at offset %zu\n", m_firstFailure);
+            }
+        }
+
+    private:
+        uint32_t m_tolerance;
+        std::array<uint64_t, 5> m_histogram{};
+        uint32_t m_maxDiff = 0u;
+        size_t m_firstFailure = SIZE_MAX;
+    };
+
+    void runCpuReference(const Input &input, const std::array<float, 3> &factors,
+                         std::vector<uint8_t> &out) {
+        out.resize(input.pixels.size());
+        HsvFilter::apply(input.pixels.data(), input.width * 4u, out.data(), input.width * 4u,
+                         input.width, input.height, factors, 0u);
+    }
+
+    /*
+     * Uploads an input once and runs HsvComputePass over it for every factor set, reading
+     * the output back into host memory after each dispatch.
+     */
+    class GpuFilter {
+    public:
+        GpuFilter(VulkanCore &core, StagingPool &stagingPool, const Input &input)
+                : m_core(core), m_device(core.getDevice()), m_input(input) {
+            createCommandBuffer();
+            createSource(stagingPool);
+            createReadback();
+            m_compute.init(m_core, VK_NULL_HANDLE, 1u, [this](std::function<void()> deleter) {
+                m_deletions.push(0u, std::move(deleter));
+            });
+            m_compute.setSource(m_sourceView, m_sampler, input.width, input.height);
+        }
+
+        ~GpuFilter() {
+            m_deletions.flush();
+            m_compute.destroy();
+            vkDestroyBuffer(m_device, m_readback, nullptr);
+            m_core.getAllocator().free(m_readbackMem);
+            vkDestroySampler(m_device, m_sampler, nullptr);
+            vkDestroyImageView(m_device, m_sourceView, nullptr);
+            vkDestroyImage(m_device, m_source, nullptr);
+            m_core.getAllocator().free(m_sourceMem);
+            vkDestroyFence(m_device, m_fence, nullptr);
+            vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        }
+
+        void run(const std::array<float, 3> &factors, std::vector<uint8_t> &out) {
+            submit([&](VkCommandBuffer cmd) {
+                m_compute.invalidate();
+                m_compute.record(cmd, 0u, factors);
+
+                // record ends with the mip blits, every level is left readable by shaders
+                VkImageMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = m_compute.getOutputImage();
+                barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+                vkCmdPipelineBarrier(cmd, Utils::SHADER_READ_STAGES,
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                                     1, &barrier);
+
+                VkBufferImageCopy region{};
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                region.imageExtent = {m_input.width, m_input.height, 1};
+                vkCmdCopyImageToBuffer(cmd, m_compute.getOutputImage(),
+                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readback, 1,
+                                       &region);
+
+                VkBufferMemoryBarrier hostBarrier{};
+                hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+                hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                hostBarrier.buffer = m_readback;
+                hostBarrier.size = VK_WHOLE_SIZE;
+                vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                     VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &hostBarrier,
+                                     0, nullptr);
+            });
+            out.resize(m_input.pixels.size());
+            memcpy(out.data(), m_readbackMem.mapped, out.size());
+        }
+
+    private:
+        void submit(const std::function<void(VkCommandBuffer)> &record) {
+            VK_CHECK(vkResetCommandBuffer(m_cmd, 0));
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            VK_CHECK(vkBeginCommandBuffer(m_cmd, &beginInfo));
+            record(m_cmd);
+            VK_CHECK(vkEndCommandBuffer(m_cmd));
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &m_cmd;
+            VK_CHECK(vkResetFences(m_device, 1, &m_fence));
+            VK_CHECK(m_core.queueSubmit(m_core.getGraphicsQueue(), 1, &submitInfo, m_fence));
+            VK_CHECK(vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, UINT64_MAX));
+            // every submission is waited for, nothing recorded so far is in use anymore
+            m_deletions.flush();
+        }
+
+        void createCommandBuffer() {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = static_cast<uint32_t>(m_core.getQueueFamily());
+            VK_CHECK(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool));
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            VK_CHECK(vkAllocateCommandBuffers(m_device, &allocInfo, &m_cmd));
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            VK_CHECK(vkCreateFence(m_device, &fenceInfo, nullptr, &m_fence));
+        }
+
+        void createSource(StagingPool &stagingPool) {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = FORMAT;
+            imageInfo.extent = {m_input.width, m_input.height, 1};
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VK_CHECK(vkCreateImage(m_device, &imageInfo, nullptr, &m_source));
+            m_sourceMem = m_core.getAllocator().allocateForImage(
+                    m_source, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_TILING_OPTIMAL);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = m_source;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = FORMAT;
+            viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            VK_CHECK(vkCreateImageView(m_device, &viewInfo, nullptr, &m_sourceView));
+
+            // hsv_filter.comp uses texelFetch, the filter never applies
+            VkSamplerCreateInfo samplerInfo{};
+            samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            samplerInfo.magFilter = VK_FILTER_NEAREST;
+            samplerInfo.minFilter = VK_FILTER_NEAREST;
+            samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            samplerInfo.maxAnisotropy = 1.0f;
+            VK_CHECK(vkCreateSampler(m_device, &samplerInfo, nullptr, &m_sampler));
+
+            StagingPool::Buffer staging = stagingPool.acquire(m_input.pixels.size());
+            memcpy(staging.data(), m_input.pixels.data(), m_input.pixels.size());
+            submit([&](VkCommandBuffer cmd) {
+                Utils::setImageLayout(cmd, m_source, VK_IMAGE_LAYOUT_UNDEFINED,
+                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      VK_PIPELINE_STAGE_HOST_BIT,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT);
+                VkBufferImageCopy region{};
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                region.imageExtent = {m_input.width, m_input.height, 1};
+                vkCmdCopyBufferToImage(cmd, staging.buffer, m_source,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                Utils::setImageLayout(cmd, m_source, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                      Utils::SHADER_READ_STAGES);
+            });
+            stagingPool.release(staging);
+        }
+
+        void createReadback() {
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = m_input.pixels.size();
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            VK_CHECK(vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_readback));
+            m_readbackMem = m_core.getAllocator().allocateForBuffer(
+                    m_readback,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        }
+
+        VulkanCore &m_core;
+        VkDevice m_device;
+        const Input &m_input;
+
+        VkCommandPool m_commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer m_cmd = VK_NULL_HANDLE;
+        VkFence m_fence = VK_NULL_HANDLE;
+        VkImage m_source = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation m_sourceMem{};
+        VkImageView m_sourceView = VK_NULL_HANDLE;
+        VkSampler m_sampler = VK_NULL_HANDLE;
+        VkBuffer m_readback = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation m_readbackMem{};
+        DeletionQueue m_deletions;
+        HsvComputePass m_compute;
+    };
+
+    // what the lut path of shader.frag computes, with exact weights instead of the GPU's;
+    // reference holds the exact filter the seam cells fall back to
+    void sampleLut(const Input &input, const std::array<float, 3> &factors,
+                   const std::vector<uint8_t> &reference, std::vector<uint8_t> &out) {
+        constexpr uint32_t N = HsvLut::SIZE;
+        std::vector<uint8_t> lut(size_t(N) * N * N * 4u);
+        HsvFilter::bakeLut(factors, N, lut.data());
+        out.resize(input.pixels.size());
+        for (size_t i = 0u; i < input.pixels.size(); i += 4u) {
+            uint32_t base[3];
+            float weight[3];
+            for (uint32_t c = 0u; c < 3u; ++c) {
+                const float texel = input.pixels[i + c] / 255.0f * (N - 1u);
+                base[c] = std::min(static_cast<uint32_t>(texel), N - 2u);
+                weight[c] = texel - base[c];
+            }
+            const int cellR = int(base[0]), cellG = int(base[1]), cellB = int(base[2]);
+            if (std::abs(cellG - cellB) <= 1 && cellR + 1 >= std::max(cellG, cellB)) {
+                memcpy(&out[i], &reference[i], 4u);
+                continue;
+            }
+            for (uint32_t c = 0u; c < 3u; ++c) {
+                float value = 0.0f;
+                for (uint32_t corner = 0u; corner < 8u; ++corner) {
+                    const uint32_t dr = corner & 1u, dg = corner >> 1 & 1u, db = corner >> 2;
+                    const float w = (dr ? weight[0] : 1.0f - weight[0]) *
+                                    (dg ? weight[1] : 1.0f - weight[1]) *
+                                    (db ? weight[2] : 1.0f - weight[2]);
+                    const size_t texel = ((base[2] + db) * N + base[1] + dg) * N + base[0] + dr;
+                    value += w * lut[texel * 4u + c];
+                }
+                out[i + c] = static_cast<uint8_t>(std::lrintf(value));
+            }
+            out[i + 3u] = input.pixels[i + 3u];
+        }
+    }
+
+    bool checkLut(const std::vector<Input> &inputs) {
+        bool passed = true;
+        std::vector<uint8_t> reference;
+        std::vector<uint8_t> result;
+        for (const auto &factors: FACTOR_SETS) {
+            Comparison comparison(LUT_TOLERANCE);
+            for (const Input &input: inputs) {
+                runCpuReference(input, factors, reference);
+                sampleLut(input, factors, reference, result);
+                comparison.add(result, reference);
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "lut%u %.2f %.2f %.2f", HsvLut::SIZE, factors[0],
+                     factors[1], factors[2]);
+            comparison.print(name);
+            passed &= comparison.passed();
+        }
+        return passed;
+    }
+
+    // every ISA the host supports against the scalar loop
+    bool checkCpu(const std::vector<Input> &inputs) {
+        bool passed = true;
+        const PixelKernels::Isa best = PixelKernels::getBestIsa();
+        std::vector<uint8_t> reference;
+        std::vector<uint8_t> result;
+        for (PixelKernels::Isa isa: {PixelKernels::Isa::Neon, PixelKernels::Isa::Ssse3,
+                                     PixelKernels::Isa::Avx2}) {
+            if (!PixelKernels::isSupported(isa)) {
+                continue;
+            }
+            Comparison comparison(CPU_TOLERANCE);
+            for (const Input &input: inputs) {
+                for (const auto &factors: FACTOR_SETS) {
+                    PixelKernels::setIsa(PixelKernels::Isa::Scalar);
+                    runCpuReference(input, factors, reference);
+                    PixelKernels::setIsa(isa);
+                    runCpuReference(input, factors, result);
+                    comparison.add(result, reference);
+                }
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "cpu %s vs scalar", PixelKernels::getIsaName(isa));
+            comparison.print(name);
+            passed &= comparison.passed();
+        }
+        PixelKernels::setIsa(best);
+        return passed;
+    }
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string assetsDir = HOST_ASSETS_DIR;
+    uint32_t tolerance = 2u;
+    bool cpuOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--assets") && i + 1 < argc) {
+            assetsDir = argv[++i];
+        } else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) {
+            tolerance = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--cpu-only")) {
+            cpuOnly = true;
+        } else {
+            fprintf(stderr, "usage: %s [--assets DIR] [--tolerance N] [--cpu-only]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    const Platform::FileAssetSource assets(assetsDir);
+    std::vector<Input> inputs;
+    inputs.push_back(makeAllColors());
+    Input texture;
+    if (loadTexture(assets, texture)) {
+        inputs.push_back(std::move(texture));
+    } else {
+        fprintf(stderr, "texture.png could not be decoded, only checking the color cube\n");
+    }
+
+    bool passed = checkCpu(inputs);
+    passed &= checkLut(inputs);
+    if (cpuOnly) {
+        return passed ? 0 : 1;
+    }
+
+    VulkanCore core;
+    core.initHeadless(std::make_unique<Platform::FileAssetSource>(assetsDir));
+    if (!HsvComputePass::isSupported(core)) {
+        fprintf(stderr, "the graphics queue of %s has no compute support\n",
+                core.getPhysDeviceProps().deviceName);
+        core.clean();
+        return 1;
+    }
+    StagingPool stagingPool;
+    stagingPool.init(core.getDevice(), core.getAllocator());
+    printf("%s, tolerance %u\n", core.getPhysDeviceProps().deviceName, tolerance);
+
+    std::vector<uint8_t> reference;
+    std::vector<uint8_t> result;
+    for (const Input &input: inputs) {
+        GpuFilter gpu(core, stagingPool, input);
+        for (const auto &factors: FACTOR_SETS) {
+            runCpuReference(input, factors, reference);
+            gpu.run(factors, result);
+            Comparison comparison(tolerance);
+            comparison.add(result, reference);
+            char name[64];
+            snprintf(name, sizeof(name), "%s %.2f %.2f %.2f", input.name.c_str(), factors[0],
+                     factors[1], factors[2]);
+            comparison.print(name);
+            passed &= comparison.passed();
+        }
+    }
+
+    stagingPool.destroy();
+    core.clean();
+    return passed ? 0 : 1;
+}
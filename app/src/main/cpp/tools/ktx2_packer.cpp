@@ -0,0 +1,522 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+/*
+ * Offline converter of PNG assets into KTX2 containers the TextureStreamer uploads as is:
+ * the full mip chain is box filtered and every level is encoded to GPU blocks.
+ *
+ * usage: ktx2_packer [--format etc2|bc1|rgba8] IN.png OUT.ktx2
+ *        ktx2_packer --astc OUT.ktx2 LEVEL0.astc [LEVEL1.astc ...]
+ *
+ * etc2 writes ETC1 compatible individual mode blocks, bc1 a bounding box fit; both drop
+ * alpha. ASTC encoding is left to astcenc, its .astc outputs (one per mip level) are
+ * wrapped as they are. Name outputs name.etc2.ktx2, name.bc.ktx2, name.astc.ktx2 or
+ * name.ktx2 next to name.png so the streamer picks them up once compressed textures are
+ * enabled (debug.myapp.compressed_textures, headless_render --compressed-textures).
+ */
+
+#include "Ktx2.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "stb_image.h"
+
+namespace {
+
+    // Khronos data format descriptor color models and channels used below
+    constexpr uint8_t KHR_DF_MODEL_RGBSDA = 1u;
+    constexpr uint8_t KHR_DF_MODEL_BC1A = 128u;
+    constexpr uint8_t KHR_DF_MODEL_ETC2 = 161u;
+    constexpr uint8_t KHR_DF_MODEL_ASTC = 162u;
+    constexpr uint8_t KHR_DF_PRIMARIES_BT709 = 1u;
+    constexpr uint8_t KHR_DF_TRANSFER_LINEAR = 1u;
+
+    constexpr uint32_t ASTC_MAGIC = 0x5CA1AB13u;
+
+    // ETC1 modifier tables, the index into a row is the 2 bit pixel index
+    constexpr int ETC1_MODIFIERS[8][4] = {
+            {2,  8,   -2,  -8},
+            {5,  17,  -5,  -17},
+            {9,  29,  -9,  -29},
+            {13, 42,  -13, -42},
+            {18, 60,  -18, -60},
+            {24, 80,  -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183},
+    };
+
+    struct DfdSample {
+        uint16_t bitOffset;
+        uint8_t bitLength;
+        uint8_t channel;
+        uint32_t lower;
+        uint32_t upper;
+    };
+
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    void putU32(std::vector<uint8_t> &out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    std::vector<uint8_t> makeDfd(uint8_t colorModel, uint32_t blockWidth, uint32_t blockHeight,
+                                 uint32_t blockBytes, const std::vector<DfdSample> &samples) {
+        const uint32_t blockSize = 24u + 16u * static_cast<uint32_t>(samples.size());
+        std::vector<uint8_t> dfd;
+        putU32(dfd, 4u + blockSize);
+        putU32(dfd, 0u); // vendor Khronos, basic descriptor type
+        putU32(dfd, 2u | (blockSize << 16u)); // version 1.3
+        putU32(dfd, colorModel | (KHR_DF_PRIMARIES_BT709 << 8u) | (KHR_DF_TRANSFER_LINEAR << 16u));
+        putU32(dfd, (blockWidth - 1u) | ((blockHeight - 1u) << 8u));
+        putU32(dfd, blockBytes);
+        putU32(dfd, 0u);
+        for (const auto &sample: samples) {
+            putU32(dfd, sample.bitOffset | (static_cast<uint32_t>(sample.bitLength - 1u) << 16u) |
+                        (static_cast<uint32_t>(sample.channel) << 24u));
+            putU32(dfd, 0u);
+            putU32(dfd, sample.lower);
+            putU32(dfd, sample.upper);
+        }
+        return dfd;
+    }
+
+    std::vector<uint8_t> getDfd(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+                return makeDfd(KHR_DF_MODEL_ETC2, 4u, 4u, 8u, {{0u, 64u, 2u, 0u, UINT32_MAX}});
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                return makeDfd(KHR_DF_MODEL_BC1A, 4u, 4u, 8u, {{0u, 64u, 0u, 0u, UINT32_MAX}});
+            case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+                return makeDfd(KHR_DF_MODEL_ASTC, 4u, 4u, 16u, {{0u, 128u, 0u, 0u, UINT32_MAX}});
+            case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+                return makeDfd(KHR_DF_MODEL_ASTC, 6u, 6u, 16u, {{0u, 128u, 0u, 0u, UINT32_MAX}});
+            case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+                return makeDfd(KHR_DF_MODEL_ASTC, 8u, 8u, 16u, {{0u, 128u, 0u, 0u, UINT32_MAX}});
+            default:
+                return makeDfd(KHR_DF_MODEL_RGBSDA, 1u, 1u, 4u,
+                               {{0u, 8u, 0u, 0u, 255u}, {8u, 8u, 1u, 0u, 255u},
+                                {16u, 8u, 2u, 0u, 255u}, {24u, 8u, 15u, 0u, 255u}});
+        }
+    }
+
+    // 4x4 texels starting at (x, y), edges are clamped
+    void fetchBlock(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t x, uint32_t y,
+                    uint8_t block[16][4]) {
+        for (uint32_t by = 0u; by < 4u; ++by) {
+            for (uint32_t bx = 0u; bx < 4u; ++bx) {
+                const uint32_t sx = std::min(x + bx, width - 1u);
+                const uint32_t sy = std::min(y + by, height - 1u);
+                memcpy(block[by * 4u + bx], rgba + (static_cast<size_t>(sy) * width + sx) * 4u, 4);
+            }
+        }
+    }
+
+    int colorError(const int a[3], const uint8_t b[4]) {
+        const int dr = a[0] - b[0];
+        const int dg = a[1] - b[1];
+        const int db = a[2] - b[2];
+        return dr * dr + dg * dg + db * db;
+    }
+
+    uint64_t encodeEtc1Block(const uint8_t block[16][4]) {
+        uint64_t bestBits = 0u;
+        int bestError = INT_MAX;
+        for (uint32_t flip = 0u; flip < 2u; ++flip) {
+            uint32_t high = (flip & 1u);
+            uint32_t msb = 0u;
+            uint32_t lsb = 0u;
+            int error = 0;
+            for (uint32_t sub = 0u; sub < 2u; ++sub) {
+                // pixel indices are column major: x * 4 + y
+                uint32_t pixels[8];
+                uint32_t count = 0u;
+                int sum[3] = {0, 0, 0};
+                for (uint32_t x = 0u; x < 4u; ++x) {
+                    for (uint32_t y = 0u; y < 4u; ++y) {
+                        if ((flip ? y / 2u : x / 2u) != sub) {
+                            continue;
+                        }
+                        pixels[count++] = x * 4u + y;
+                        for (int c = 0; c < 3; ++c) {
+                            sum[c] += block[y * 4u + x][c];
+                        }
+                    }
+                }
+
+                int base4[3];
+                int base[3];
+                for (int c = 0; c < 3; ++c) {
+                    base4[c] = std::clamp((sum[c] * 15 + 8 * 255 / 2) / (8 * 255), 0, 15);
+                    base[c] = base4[c] * 17;
+                }
+
+                int bestTableError = INT_MAX;
+                uint32_t bestTable = 0u;
+                uint32_t bestMsb = 0u;
+                uint32_t bestLsb = 0u;
+                for (uint32_t table = 0u; table < 8u; ++table) {
+                    int tableError = 0;
+                    uint32_t tableMsb = 0u;
+                    uint32_t tableLsb = 0u;
+                    for (uint32_t i = 0u; i < count; ++i) {
+                        const uint32_t p = pixels[i];
+                        const uint8_t *texel = block[(p % 4u) * 4u + p / 4u];
+                        int bestPixelError = INT_MAX;
+                        uint32_t bestIndex = 0u;
+                        for (uint32_t index = 0u; index < 4u; ++index) {
+                            const int modifier = ETC1_MODIFIERS[table][index];
+                            const int color[3] = {std::clamp(base[0] + modifier, 0, 255),
+                                                  std::clamp(base[1] + modifier, 0, 255),
+                                                  std::clamp(base[2] + modifier, 0, 255)};
+                            const int pixelError = colorError(color, texel);
+                            if (pixelError < bestPixelError) {
+                                bestPixelError = pixelError;
+                                bestIndex = index;
+                            }
+                        }
+                        tableError += bestPixelError;
+                        tableMsb |= (bestIndex >> 1u) << p;
+                        tableLsb |= (bestIndex & 1u) << p;
+                    }
+                    if (tableError < bestTableError) {
+                        bestTableError = tableError;
+                        bestTable = table;
+                        bestMsb = tableMsb;
+                        bestLsb = tableLsb;
+                    }
+                }
+
+                // individual mode: 4 bit colors, subblock 1 in the high nibbles
+                const uint32_t shift = sub == 0u ? 4u : 0u;
+                high |= (static_cast<uint32_t>(base4[0]) << (24u + shift)) |
+                        (static_cast<uint32_t>(base4[1]) << (16u + shift)) |
+                        (static_cast<uint32_t>(base4[2]) << (8u + shift)) |
+                        (bestTable << (sub == 0u ? 5u : 2u));
+                msb |= bestMsb;
+                lsb |= bestLsb;
+                error += bestTableError;
+            }
+            if (error < bestError) {
+                bestError = error;
+                bestBits = (static_cast<uint64_t>(high) << 32u) | (msb << 16u) | lsb;
+            }
+        }
+        return bestBits;
+    }
+
+    uint16_t toRgb565(const int color[3]) {
+        return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11 |
+                                     ((color[1] * 63 + 127) / 255) << 5 |
+                                     ((color[2] * 31 + 127) / 255));
+    }
+
+    void fromRgb565(uint16_t packed, int color[3]) {
+        const int r = (packed >> 11) & 31;
+        const int g = (packed >> 5) & 63;
+        const int b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    uint64_t encodeBc1Block(const uint8_t block[16][4]) {
+        int lo[3] = {255, 255, 255};
+        int hi[3] = {0, 0, 0};
+        int mean[3] = {0, 0, 0};
+        for (uint32_t i = 0u; i < 16u; ++i) {
+            const uint8_t *texel = block[i];
+            for (int c = 0; c < 3; ++c) {
+                lo[c] = std::min<int>(lo[c], texel[c]);
+                hi[c] = std::max<int>(hi[c], texel[c]);
+                mean[c] += texel[c];
+            }
+        }
+
+        // pick the bounding box diagonal following the dominant channel's correlation
+        int dominant = 0;
+        for (int c = 1; c < 3; ++c) {
+            if (hi[c] - lo[c] > hi[dominant] - lo[dominant]) {
+                dominant = c;
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            mean[c] /= 16;
+        }
+        for (int c = 0; c < 3; ++c) {
+            if (c == dominant) {
+                continue;
+            }
+            int covariance = 0;
+            for (uint32_t i = 0u; i < 16u; ++i) {
+                const uint8_t *texel = block[i];
+                covariance += (texel[dominant] - mean[dominant]) * (texel[c] - mean[c]);
+            }
+            if (covariance < 0) {
+                std::swap(lo[c], hi[c]);
+            }
+        }
+        // inset by 1/16 of the range, the extremes are rarely hit exactly
+        for (int c = 0; c < 3; ++c) {
+            const int inset = (hi[c] - lo[c]) / 16;
+            hi[c] -= inset;
+            lo[c] += inset;
+        }
+
+        uint16_t c0 = toRgb565(hi);
+        uint16_t c1 = toRgb565(lo);
+        if (c0 < c1) {
+            std::swap(c0, c1);
+        }
+        uint32_t indices = 0u;
+        if (c0 != c1) {
+            // c0 > c1 selects the opaque four color mode
+            int palette[4][3];
+            fromRgb565(c0, palette[0]);
+            fromRgb565(c1, palette[1]);
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (uint32_t i = 0u; i < 16u; ++i) {
+                int bestError = INT_MAX;
+                uint32_t bestIndex = 0u;
+                for (uint32_t index = 0u; index < 4u; ++index) {
+                    const int error = colorError(palette[index], block[i]);
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = index;
+                    }
+                }
+                indices |= bestIndex << (i * 2u);
+            }
+        }
+        return c0 | (static_cast<uint64_t>(c1) << 16u) | (static_cast<uint64_t>(indices) << 32u);
+    }
+
+    std::vector<uint8_t> encodeLevel(VkFormat format, const std::vector<uint8_t> &rgba,
+                                     uint32_t width, uint32_t height) {
+        if (format == VK_FORMAT_R8G8B8A8_UNORM) {
+            return rgba;
+        }
+        std::vector<uint8_t> out;
+        uint8_t block[16][4];
+        for (uint32_t y = 0u; y < height; y += 4u) {
+            for (uint32_t x = 0u; x < width; x += 4u) {
+                fetchBlock(rgba.data(), width, height, x, y, block);
+                if (format == VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK) {
+                    // ETC blocks are stored big endian
+                    const uint64_t bits = encodeEtc1Block(block);
+                    for (int i = 7; i >= 0; --i) {
+                        out.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+                    }
+                } else {
+                    const uint64_t bits = encodeBc1Block(block);
+                    for (int i = 0; i < 8; ++i) {
+                        out.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
+    bool readFile(const char *path, std::vector<uint8_t> &content) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        content.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(content.data()),
+                  static_cast<std::streamsize>(content.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool packPng(const char *inPath, VkFormat format, std::vector<Level> &levels) {
+        int width, height, channels;
+        unsigned char *pixels = stbi_load(inPath, &width, &height, &channels, 4);
+        if (!pixels) {
+            fprintf(stderr, "failed to decode %s: %s\n", inPath, stbi_failure_reason());
+            return false;
+        }
+        std::vector<uint8_t> rgba(pixels, pixels + static_cast<size_t>(width) * height * 4u);
+        stbi_image_free(pixels);
+
+        uint32_t levelWidth = static_cast<uint32_t>(width);
+        uint32_t levelHeight = static_cast<uint32_t>(height);
+        const uint32_t mipLevels = Utils::getMipLevelCount(levelWidth, levelHeight);
+        for (uint32_t level = 0u; level < mipLevels; ++level) {
+            levels.push_back({levelWidth, levelHeight,
+                              encodeLevel(format, rgba, levelWidth, levelHeight)});
+            if (level + 1u < mipLevels) {
+                const uint32_t nextWidth = std::max(levelWidth / 2u, 1u);
+                const uint32_t nextHeight = std::max(levelHeight / 2u, 1u);
+                std::vector<uint8_t> next(static_cast<size_t>(nextWidth) * nextHeight * 4u);
+                Utils::downsampleRGBA8(rgba.data(), levelWidth, levelHeight, next.data(),
+                                       nextWidth, nextHeight);
+                rgba.swap(next);
+                levelWidth = nextWidth;
+                levelHeight = nextHeight;
+            }
+        }
+        return true;
+    }
+
+    bool wrapAstc(const std::vector<const char *> &inPaths, VkFormat &format,
+                  std::vector<Level> &levels) {
+        for (const char *path: inPaths) {
+            std::vector<uint8_t> content;
+            uint32_t magic = 0u;
+            if (!readFile(path, content) || content.size() < 16u ||
+                (memcpy(&magic, content.data(), 4), magic != ASTC_MAGIC)) {
+                fprintf(stderr, "%s is not an .astc file\n", path);
+                return false;
+            }
+            const uint32_t blockWidth = content[4];
+            const uint32_t blockHeight = content[5];
+            const uint32_t width = content[7] | (content[8] << 8u) | (content[9] << 16u);
+            const uint32_t height = content[10] | (content[11] << 8u) | (content[12] << 16u);
+
+            VkFormat levelFormat;
+            if (blockWidth == 4u && blockHeight == 4u) {
+                levelFormat = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            } else if (blockWidth == 6u && blockHeight == 6u) {
+                levelFormat = VK_FORMAT_ASTC_6x6_UNORM_BLOCK;
+            } else if (blockWidth == 8u && blockHeight == 8u) {
+                levelFormat = VK_FORMAT_ASTC_8x8_UNORM_BLOCK;
+            } else {
+                fprintf(stderr, "%s: unsupported block size %ux%u\n", path, blockWidth,
+                        blockHeight);
+                return false;
+            }
+            if (levels.empty()) {
+                format = levelFormat;
+            } else if (levelFormat != format ||
+                       width != std::max(levels[0].width >> levels.size(), 1u) ||
+                       height != std::max(levels[0].height >> levels.size(), 1u)) {
+                fprintf(stderr, "%s does not continue the mip chain\n", path);
+                return false;
+            }
+            levels.push_back({width, height, std::vector<uint8_t>(content.begin() + 16,
+                                                                  content.end())});
+        }
+        return true;
+    }
+
+    bool writeKtx2(const char *outPath, VkFormat format, const std::vector<Level> &levels) {
+        Ktx2::FormatInfo info;
+        Ktx2::getFormatInfo(format, info);
+        const std::vector<uint8_t> dfd = getDfd(format);
+
+        Ktx2::Header header{};
+        memcpy(header.identifier, Ktx2::IDENTIFIER.data(), Ktx2::IDENTIFIER.size());
+        header.vkFormat = format;
+        header.typeSize = 1u;
+        header.pixelWidth = levels[0].width;
+        header.pixelHeight = levels[0].height;
+        header.faceCount = 1u;
+        header.levelCount = static_cast<uint32_t>(levels.size());
+        header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2::Header) +
+                                                     levels.size() * sizeof(Ktx2::LevelIndex));
+        header.dfdByteLength = static_cast<uint32_t>(dfd.size());
+
+        // level data is aligned to lcm(block size, 4) and stored smallest level first
+        std::vector<Ktx2::LevelIndex> index(levels.size());
+        const size_t alignment = std::max(info.blockBytes, 4u);
+        size_t offset = header.dfdByteOffset + dfd.size();
+        for (size_t level = levels.size(); level-- > 0u;) {
+            offset = (offset + alignment - 1u) / alignment * alignment;
+            const size_t expected = Ktx2::getLevelSize(info, levels[level].width,
+                                                       levels[level].height);
+            if (levels[level].data.size() != expected) {
+                fprintf(stderr, "level %zu has %zu bytes, expected %zu\n", level,
+                        levels[level].data.size(), expected);
+                return false;
+            }
+            index[level] = {offset, expected, expected};
+            offset += expected;
+        }
+
+        std::vector<uint8_t> file(offset, 0u);
+        memcpy(file.data(), &header, sizeof(header));
+        memcpy(file.data() + sizeof(header), index.data(), index.size() * sizeof(index[0]));
+        memcpy(file.data() + header.dfdByteOffset, dfd.data(), dfd.size());
+        for (size_t level = 0u; level < levels.size(); ++level) {
+            memcpy(file.data() + index[level].byteOffset, levels[level].data.data(),
+                   levels[level].data.size());
+        }
+
+        std::ofstream out(outPath, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(file.data()),
+                  static_cast<std::streamsize>(file.size()));
+        if (!out) {
+            fprintf(stderr, "failed to write %s\n", outPath);
+            return false;
+        }
+        printf("%s: %ux%u, format %d, %zu levels, %zu bytes\n", outPath, header.pixelWidth,
+               header.pixelHeight, format, levels.size(), file.size());
+        return true;
+    }
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    VkFormat format = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+    bool astc = false;
+    std::vector<const char *> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (!strcmp(name, "etc2")) {
+                format = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            } else if (!strcmp(name, "bc1")) {
+                format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            } else if (!strcmp(name, "rgba8")) {
+                format = VK_FORMAT_R8G8B8A8_UNORM;
+            } else {
+                paths.clear();
+                break;
+            }
+        } else if (!strcmp(argv[i], "--astc")) {
+            astc = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() < 2u || (!astc && paths.size() != 2u)) {
+        fprintf(stderr, "usage: %s [--format etc2|bc1|rgba8] IN.png OUT.ktx2\n"
+                        "       %s --astc OUT.ktx2 LEVEL0.astc [LEVEL1.astc ...]\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    std::vector<Level> levels;
+    const char *outPath;
+    if (astc) {
+        outPath = paths[0];
+        if (!wrapAstc({paths.begin() + 1, paths.end()}, format, levels)) {
+            return 1;
+        }
+    } else {
+        outPath = paths[1];
+        if (!packPng(paths[0], format, levels)) {
+            return 1;
+        }
+    }
+    return writeKtx2(outPath, format, levels) ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+//
+// Created by s_y_r_u_s_e on 17.10.2026.
+//
+
+/*
+ * Throughput of the PixelKernels implementations the CPU supports against the byte wise
+ * loop the texture loader used to run, on an image with a padded destination row pitch
+ * like the ones vkGetImageSubresourceLayout reports. Outputs are checked against scalar.
+ * --check skips the timing and compares every kernel byte for byte with scalar over widths
+ * that hit each SIMD tail, packed and padded pitches, in place calls and every color/alpha
+ * pair, this is the ctest pixel_kernels_exact.
+ *
+ * usage: pixel_kernels_bench [--size WIDTHxHEIGHT] [--runs N] [--check]
+ */
+
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr size_t ROW_PITCH_ALIGNMENT = 256u;
+
+    struct Image {
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        size_t pitch;
+        std::vector<uint8_t> data;
+
+        Image(uint32_t w, uint32_t h, uint32_t c, size_t alignment)
+                : width(w), height(h), channels(c),
+                  pitch((w * c + alignment - 1u) / alignment * alignment),
+                  data(pitch * h, 0u) {
+        }
+
+        bool rowsEqual(const Image &other) const {
+            for (uint32_t y = 0u; y < height; ++y) {
+                if (memcmp(&data[y * pitch], &other.data[y * other.pitch], width * channels)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // what loadTextureFromFile did: one byte per store, indices recomputed per channel
+    void legacyCopy(const Image &src, Image &dst) {
+        for (uint32_t y = 0; y < src.height; y++) {
+            unsigned char *row = dst.data.data() + dst.pitch * y;
+            for (uint32_t x = 0; x < src.width; x++) {
+                row[x * 4] = src.data[(x + y * src.width) * 4];
+                row[x * 4 + 1] = src.data[(x + y * src.width) * 4 + 1];
+                row[x * 4 + 2] = src.data[(x + y * src.width) * 4 + 2];
+                row[x * 4 + 3] = src.data[(x + y * src.width) * 4 + 3];
+            }
+        }
+    }
+
+    using KernelFn = void (*)(const uint8_t *, size_t, uint8_t *, size_t, uint32_t, uint32_t);
+
+    constexpr PixelKernels::Isa SIMD_ISAS[] = {PixelKernels::Isa::Neon, PixelKernels::Isa::Ssse3,
+                                               PixelKernels::Isa::Avx2};
+
+    // fn run with the given implementation into dst, in place when inPlace is set
+    void runKernel(PixelKernels::Isa isa, KernelFn fn, const Image &src, Image &dst,
+                   bool inPlace) {
+        PixelKernels::setIsa(isa);
+        if (inPlace) {
+            dst.data = src.data;
+            fn(dst.data.data(), dst.pitch, dst.data.data(), dst.pitch, dst.width, dst.height);
+        } else {
+            std::fill(dst.data.begin(), dst.data.end(), 0u);
+            fn(src.data.data(), src.pitch, dst.data.data(), dst.pitch, dst.width, dst.height);
+        }
+    }
+
+    // one kernel and one source against scalar, returns the number of differing images
+    uint32_t checkKernel(const char *name, KernelFn fn, const Image &src, size_t dstAlignment,
+                         bool inPlace) {
+        Image reference(src.width, src.height, 4u, inPlace ? 1u : dstAlignment);
+        Image out(src.width, src.height, 4u, inPlace ? 1u : dstAlignment);
+        runKernel(PixelKernels::Isa::Scalar, fn, src, reference, inPlace);
+        uint32_t failures = 0u;
+        for (PixelKernels::Isa isa: SIMD_ISAS) {
+            if (!PixelKernels::isSupported(isa)) {
+                continue;
+            }
+            runKernel(isa, fn, src, out, inPlace);
+            if (!out.rowsEqual(reference)) {
+                printf("%-18s %-7s %ux%u pitch %zu%s  MISMATCH\n", name,
+                       PixelKernels::getIsaName(isa), src.width, src.height, out.pitch,
+                       inPlace ? " in place" : "");
+                ++failures;
+            }
+        }
+        return failures;
+    }
+
+    int check() {
+        const PixelKernels::Isa best = PixelKernels::getBestIsa();
+        std::mt19937 rng(11u);
+        uint32_t images = 0u;
+        uint32_t failures = 0u;
+        // 1..130 covers every tail of the 4, 8 and 16 pixel loops and several full blocks
+        for (uint32_t width = 1u; width <= 130u; ++width) {
+            Image rgb(width, 3u, 3u, 1u);
+            Image rgba(width, 3u, 4u, 1u);
+            for (auto &byte: rgb.data) {
+                byte = static_cast<uint8_t>(rng());
+            }
+            for (auto &byte: rgba.data) {
+                byte = static_cast<uint8_t>(rng());
+            }
+            for (size_t alignment: {size_t(1u), ROW_PITCH_ALIGNMENT}) {
+                failures += checkKernel("rgbToRgba", PixelKernels::rgbToRgba, rgb, alignment,
+                                        false);
+                failures += checkKernel("swizzleBgra", PixelKernels::swizzleBgra, rgba,
+                                        alignment, false);
+                failures += checkKernel("premultiplyAlpha", PixelKernels::premultiplyAlpha, rgba,
+                                        alignment, false);
+                images += 3u;
+            }
+            failures += checkKernel("swizzleBgra", PixelKernels::swizzleBgra, rgba, 1u, true);
+            failures += checkKernel("premultiplyAlpha", PixelKernels::premultiplyAlpha, rgba, 1u,
+                                    true);
+            images += 2u;
+        }
+
+        // every color value under every alpha, the rounding of the divide by 255 is the part
+        // a vector implementation gets wrong most easily
+        Image table(256u, 256u, 4u, 1u);
+        for (uint32_t alpha = 0u; alpha < 256u; ++alpha) {
+            for (uint32_t color = 0u; color < 256u; ++color) {
+                uint8_t *px = &table.data[alpha * table.pitch + color * 4u];
+                px[0] = static_cast<uint8_t>(color);
+                px[1] = static_cast<uint8_t>(255u - color);
+                px[2] = static_cast<uint8_t>(color ^ alpha);
+                px[3] = static_cast<uint8_t>(alpha);
+            }
+        }
+        failures += checkKernel("premultiplyAlpha", PixelKernels::premultiplyAlpha, table, 1u,
+                                false);
+        ++images;
+        PixelKernels::setIsa(best);
+
+        printf("checked");
+        for (PixelKernels::Isa isa: SIMD_ISAS) {
+            if (PixelKernels::isSupported(isa)) {
+                printf(" %s", PixelKernels::getIsaName(isa));
+            }
+        }
+        printf(" against scalar on %u images, %u mismatches, default %s\n", images, failures,
+               PixelKernels::getIsaName(best));
+        return failures ? 1 : 0;
+    }
+
+    double measure(uint32_t runs, size_t bytes, const std::function<void()> &kernel) {
+        kernel(); // warm the caches and page in the destination
+        double best = 1e30;
+        for (uint32_t i = 0u; i < runs; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+        return bytes / best / 1e9;
+    }
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    uint32_t width = 4096u;
+    uint32_t height = 4096u;
+    uint32_t runs = 10u;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            sscanf(argv[++i], "%ux%u", &width, &height);
+        } else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--check")) {
+            return check();
+        } else {
+            fprintf(stderr, "usage: %s [--size WxH] [--runs N] [--check]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // tightly packed sources as decoded by stb_image, pitched destinations
+    Image rgba(width, height, 4u, 1u);
+    Image rgb(width, height, 3u, 1u);
+    std::mt19937 rng(7u);
+    for (auto &byte: rgba.data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    for (auto &byte: rgb.data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    Image reference(width, height, 4u, ROW_PITCH_ALIGNMENT);
+    Image out(width, height, 4u, ROW_PITCH_ALIGNMENT);
+
+    const size_t rgbaBytes = size_t(width) * height * 4u;
+    const size_t rgbBytes = size_t(width) * height * 3u;
+    printf("%ux%u, destination pitch %zu, best of %u runs, GB/s of bytes read + written\n",
+           width, height, out.pitch, runs);
+
+    printf("%-18s %-7s %8.2f\n", "copy (legacy)", "scalar",
+           measure(runs, 2u * rgbaBytes, [&]() { legacyCopy(rgba, out); }));
+    printf("%-18s %-7s %8.2f\n", "copyRows", "memcpy",
+           measure(runs, 2u * rgbaBytes, [&]() {
+               PixelKernels::copyRows(rgba.data.data(), rgba.pitch, out.data.data(), out.pitch,
+                                      width * 4u, height);
+           }));
+
+    struct Kernel {
+        const char *name;
+        const Image &src;
+        size_t bytes;
+        KernelFn fn;
+    };
+    const Kernel kernels[] = {
+            {"rgbToRgba",        rgb,  rgbBytes + rgbaBytes, PixelKernels::rgbToRgba},
+            {"swizzleBgra",      rgba, 2u * rgbaBytes,       PixelKernels::swizzleBgra},
+            {"premultiplyAlpha", rgba, 2u * rgbaBytes,       PixelKernels::premultiplyAlpha},
+    };
+
+    const PixelKernels::Isa best = PixelKernels::getBestIsa();
+    bool mismatch = false;
+    for (const auto &kernel: kernels) {
+        PixelKernels::setIsa(PixelKernels::Isa::Scalar);
+        kernel.fn(kernel.src.data.data(), kernel.src.pitch, reference.data.data(),
+                  reference.pitch, width, height);
+        for (PixelKernels::Isa isa: {PixelKernels::Isa::Scalar, PixelKernels::Isa::Neon,
+                                     PixelKernels::Isa::Ssse3, PixelKernels::Isa::Avx2}) {
+            if (!PixelKernels::isSupported(isa)) {
+                continue;
+            }
+            PixelKernels::setIsa(isa);
+            std::fill(out.data.begin(), out.data.end(), 0u);
+            const double gbs = measure(runs, kernel.bytes, [&]() {
+                kernel.fn(kernel.src.data.data(), kernel.src.pitch, out.data.data(), out.pitch,
+                          width, height);
+            });
+            const bool ok = out.rowsEqual(reference);
+            mismatch |= !ok;
+            printf("%-18s %-7s %8.2f%s\n", kernel.name, PixelKernels::getIsaName(isa), gbs,
+                   ok ? "" : "  MISMATCH");
+        }
+    }
+    PixelKernels::setIsa(best);
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+package com.android.myapp
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Filter parameters shared with the native render loop through a direct buffer, so a slider
+ * move is a few memory stores instead of a JNI call. The layout matches ParamBlock.h: native
+ * endian 32 bit words, a seqlock sequence first. Only the main thread writes it.
+ */
+object ParamBlock {
+    private const val SEQUENCE = 0
+    private const val NATIVE_IDLE = 4
+    private const val HUE = 8
+    private const val SATURATION = 12
+    private const val INTENSITY = 16
+    private const val SIZE = 20
+
+    private val buffer: ByteBuffer =
+        ByteBuffer.allocateDirect(SIZE).order(ByteOrder.nativeOrder())
+    private var sequence = 0
+
+    @Volatile
+    private var barrier = 0
+
+    /**
+     * Hands the buffer to native code, once per process. False if native code rejected it,
+     * the parameters then have to go through applyFilterOverJNI
+     */
+    val registered: Boolean by lazy { registerBuffer(buffer) }
+
+    fun write(hue: Float, saturation: Float, intensity: Float) {
+        // odd while the factors are in flux, the native reader skips such snapshots
+        buffer.putInt(SEQUENCE, ++sequence)
+        fence()
+        buffer.putFloat(HUE, hue)
+        buffer.putFloat(SATURATION, saturation)
+        buffer.putFloat(INTENSITY, intensity)
+        fence()
+        buffer.putInt(SEQUENCE, ++sequence)
+        fence()
+        // the render loop only sleeps after it checked the sequence, wake it if it does
+        if (buffer.getInt(NATIVE_IDLE) != 0) {
+            wakeRenderLoop()
+        }
+    }
+
+    // A volatile store followed by a volatile load is a full barrier in ART (stlr + ldar on
+    // arm64, dmb on arm), which keeps the plain buffer accesses on either side in order for
+    // the native reader. VarHandle.fullFence() would say so directly but needs API 33.
+    private fun fence() {
+        barrier = sequence
+        sequence = barrier
+    }
+
+    @JvmStatic
+    private external fun registerBuffer(buffer: ByteBuffer): Boolean
+
+    @JvmStatic
+    private external fun wakeRenderLoop()
+}
@@ -22,21 +22,21 @@ class VulkanActivity : GameActivity() {
         hideSystemUI()
         supportFragmentManager.beginTransaction().add(R.id.content, ControlsFragment()).commit()
         AppState.getHue().observe(this, Observer { hue ->
-            applyFilterOverJNI(
+            applyFilter(
                 hue,
                 AppState.getSaturation().value!!,
                 AppState.getIntensity().value!!
             )
         })
         AppState.getSaturation().observe(this, Observer { saturation ->
-            applyFilterOverJNI(
+            applyFilter(
                 AppState.getHue().value!!,
                 saturation,
                 AppState.getIntensity().value!!
             )
         })
         AppState.getIntensity().observe(this, Observer { intensity ->
-            applyFilterOverJNI(
+            applyFilter(
                 AppState.getHue().value!!,
                 AppState.getSaturation().value!!,
                 intensity
@@ -44,6 +44,17 @@ class VulkanActivity : GameActivity() {
         })
     }
 
+    // The shared parameter block needs no JNI call per change, applyFilterOverJNI is the
+    // fallback and the baseline for the JNI call rate the native side logs. Native code only
+    // accepts the block with debug.myapp.param_block set
+    private fun applyFilter(hue: Float, saturation: Float, intensity: Float) {
+        if (ParamBlock.registered) {
+            ParamBlock.write(hue, saturation, intensity)
+        } else {
+            applyFilterOverJNI(hue, saturation, intensity)
+        }
+    }
+
     private fun hideSystemUI() {
         // This will put the game behind any cutouts and waterfalls on devices which have
         // them, so the corresponding insets will be non-zero.
@@ -0,0 +1,19 @@
+#version 450
+
+// Full screen triangle feeding shader.frag for tools/hsv_filter_bench.cpp,
+// so every fragment of the target goes through the filter
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec4 fragHSVFactors;
+
+layout(push_constant) uniform constants
+{
+    vec3 hsv_factors;
+    float filter_mode;
+} PushConstants;
+
+void main() {
+    const vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    fragTexCoord = uv;
+    fragHSVFactors = vec4(PushConstants.hsv_factors, PushConstants.filter_mode);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
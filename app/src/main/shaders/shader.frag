@@ -1,6 +1,8 @@
 #version 450
 
 layout(binding = 1) uniform sampler2D texSampler;
+layout(binding = 2) uniform sampler2D filteredSampler;// written by hsv_filter.comp
+layout(binding = 3) uniform sampler3D lutSampler;// HSV adjustment baked by HsvLut
 layout(location = 0) in vec2 fragTexCoord;
 layout(location = 1) in vec4 fragHSVFactors;
 layout(location = 0) out vec4 outColor;
@@ -28,6 +30,27 @@ vec3 HSVtoRGB(in vec3 HSV)
 }
 
 void main() {
+    // one trilinear lookup, lattice points sit on texel centers
+    if (fragHSVFactors.a > 2.5) {
+        vec4 color = texture(texSampler, fragTexCoord);
+        float size = float(textureSize(lutSampler, 0).x);
+        // Hue wraps from 1 to 0 where g == b under a red maximum. Cells straddling that seam
+        // would blend both ends of the scaled hue, their colors (about 5% of the RGB cube)
+        // fall through to the exact path below
+        vec3 cell = min(floor(color.rgb * (size - 1.0)), vec3(size - 2.0));
+        if (abs(cell.g - cell.b) > 1.5 || cell.r + 1.0 < max(cell.g, cell.b)) {
+            vec3 coord = color.rgb * ((size - 1.0) / size) + 0.5 / size;
+            outColor = vec4(texture(lutSampler, coord).rgb, color.a);
+            return;
+        }
+    }
+
+    // the compute pass has already filtered the whole texture
+    if (fragHSVFactors.a > 1.5) {
+        outColor = texture(filteredSampler, fragTexCoord);
+        return;
+    }
+
     vec4 color = texture(texSampler, fragTexCoord);
 
     // enabling filter for the right quad only
@@ -1,7 +1,7 @@
 #version 450
 
 layout(location = 0) out vec2 fragTexCoord;
-layout(location = 1) out vec4 fragHSVFactors;// last component indicates whether filter is enabled\disabled
+layout(location = 1) out vec4 fragHSVFactors;// last component: 0 no filter, 1 filter per fragment, 2 compute filtered, 3 LUT
 // Currently MVP containing rotation matix
 layout(binding = 0) uniform UniformBufferObject {
     mat4 MVP;
@@ -10,6 +10,7 @@ layout(binding = 0) uniform UniformBufferObject {
 layout(push_constant) uniform constants
 {
     vec3 hsv_factors;
+    float filter_mode;// 1 filters per fragment, 2 samples the output of hsv_filter.comp, 3 the LUT
 } PushConstants;
 
 vec2 positions[6] = vec2[](
@@ -37,7 +38,7 @@ void main() {
     fragHSVFactors = vec4(PushConstants.hsv_factors, 0.0);
     if (isRightQuad) {
         pos.x = 1.0 + pos.x;
-        fragHSVFactors.a = 1.0;// enabling filter for the second quad only
+        fragHSVFactors.a = PushConstants.filter_mode;// enabling filter for the second quad only
     }
     gl_Position = ubo.MVP * vec4(pos, 0.0, 1.0);
     fragTexCoord = tex_coords[index];